@@ -468,7 +468,9 @@ wrap_dt = new MultipleDThread2D(cwrap, 2);
 //init_dt = new MultipleDThread(cinitiator, 1, blocks);
 multAdd_dt = new MultipleDThread2D(csymMultAdd, 2, blocks, blocks);
 factorize_dt = new MultipleDThread(cfactorize, 1, blocks);
-matmul_dt = new MultipleDThread3D(cmatmul, 3, blocks, blocks, blocks);
+// matmul is executed only for Middle < Outer <= Inner, thus its SM holds only the Ready Counts of this (tetrahedral) domain
+matmul_dt = new MultipleDThread3D(cmatmul, 3, blocks, blocks, blocks,
+    ContextDomain().greaterThan(OUTER_CONTEXT, MIDDLE_CONTEXT).greaterEqual(INNER_CONTEXT, OUTER_CONTEXT));
 wrap_dt = new MultipleDThread2D(cwrap, 2, blocks, blocks);
 #endif
 
@@ -260,7 +260,9 @@ int main(int argc, char* argv[]) {
 	diagDT = new MultipleDThread(diag_thread, 2, blocks);
 	frontDT = new MultipleDThread2D(front_thread, 3, blocks, blocks);
 	downDT = new MultipleDThread2D(down_thread, 3, blocks, blocks);
-	combDT = new MultipleDThread3D(comb_thread, 4, blocks, blocks, blocks);
+	// comb is executed only for Middle > Outer and Inner > Outer, thus its SM holds only the Ready Counts of this domain
+	combDT = new MultipleDThread3D(comb_thread, 4, blocks, blocks, blocks,
+	    ContextDomain().greaterThan(MIDDLE_CONTEXT, OUTER_CONTEXT).greaterThan(INNER_CONTEXT, OUTER_CONTEXT));
 #endif
 
 	cout << "DThreads are created\n";
@@ -309,7 +309,9 @@ void parallel(int *argc, char ***argv, unsigned int numKernels) {
 	dtsqrtDT = new MultipleDThread2D(dtsqrtDT_code, 3, blocks, blocks);
 #endif
 
-	dtssrfbDT = new MultipleDThread3D(dtssrfbDT_code, 4, blocks, blocks, blocks);
+	// dtssrfb is executed only for Middle > Outer and Inner > Outer, thus its SM holds only the Ready Counts of this domain
+	dtssrfbDT = new MultipleDThread3D(dtssrfbDT_code, 4, blocks, blocks, blocks,
+	    ContextDomain().greaterThan(MIDDLE_CONTEXT, OUTER_CONTEXT).greaterThan(INNER_CONTEXT, OUTER_CONTEXT));
 
 	cout << "DThreads are created\n";
 
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * queues.cpp
+ *
+ * Description: Microbenchmark of the Input and Output Queues of the TSU. A producer thread pushes a number of entries
+ * into a queue and a consumer thread pops them. The throughput of each queue is reported.
+ * The threads yield their core when the queue is full or empty, thus the benchmark can also run on fewer than two cores.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <freddo/TSU/InputQueue.h>
+#include <freddo/TSU/OutputQueue.h>
+#include <freddo/Timer/Timer.h>
+
+using namespace std;
+
+unsigned long numOfItems;  // The number of entries that pass through each queue
+InputQueue* inputQueue;
+OutputQueue* outputQueue;
+volatile unsigned long checksum;  // Keeps the consumers from being optimized away
+
+/* The producer of the Input Queue (it plays the role of a Kernel) */
+void* iqProducer(void* arg) {
+	for (unsigned long i = 0; i < numOfItems; ++i)
+		while (!inputQueue->enqueue((TID) i, (context_t) i))
+			sched_yield();  // The queue is full
+
+	return NULL;
+}
+
+/* The consumer of the Input Queue (it plays the role of the TSU) */
+void* iqConsumer(void* arg) {
+	IQ_Entry items[DEFAULT_IQ_BURST];
+	unsigned long received = 0, sum = 0;
+
+	while (received < numOfItems) {
+		UInt count = inputQueue->dequeue(items, DEFAULT_IQ_BURST);
+
+		if (count == 0)
+			sched_yield();  // The queue is empty
+
+		for (UInt i = 0; i < count; ++i)
+			sum += items[i].context;
+
+		received += count;
+	}
+
+	checksum = sum;
+	return NULL;
+}
+
+/* The producer of the Output Queue (it plays the role of the TSU) */
+void* oqProducer(void* arg) {
+	for (unsigned long i = 0; i < numOfItems; ++i)
+		while (!outputQueue->enqueue(nullptr, (context_t) i, Nesting::ONE))
+			sched_yield();  // The queue is full
+
+	return NULL;
+}
+
+/* The consumer of the Output Queue (it plays the role of a Kernel) */
+void* oqConsumer(void* arg) {
+	OQ_Entry item;
+	unsigned long received = 0, sum = 0;
+
+	while (received < numOfItems) {
+		if (outputQueue->isEmpty()) {
+			sched_yield();
+			continue;
+		}
+
+		outputQueue->peekHead(&item);
+		sum += item.context;
+		outputQueue->popHead();
+		received++;
+	}
+
+	checksum = sum;
+	return NULL;
+}
+
+/* Runs a producer and a consumer concurrently and returns the elapsed time */
+double runPair(void* (*producer)(void*), void* (*consumer)(void*)) {
+	pthread_t producerThread, consumerThread;
+
+	double t0 = gtod_micro();
+	pthread_create(&consumerThread, NULL, consumer, NULL);
+	pthread_create(&producerThread, NULL, producer, NULL);
+	pthread_join(producerThread, NULL);
+	pthread_join(consumerThread, NULL);
+	double t1 = gtod_micro();
+
+	if (checksum != numOfItems * (numOfItems - 1) / 2) {
+		printf("Error: the consumer received wrong entries\n");
+		exit(-1);
+	}
+
+	return t1 - t0;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc != 3) {
+		printf("Usage: %s <number of items> <repetitions>\n", argv[0]);
+		exit(-1);
+	}
+
+	numOfItems = atol(argv[1]);
+	int repetitions = atoi(argv[2]);
+	double bestIQ = 0, bestOQ = 0;
+
+	inputQueue = new InputQueue();
+	outputQueue = new OutputQueue();
+
+	for (int r = 0; r < repetitions; ++r) {
+		double timeIQ = runPair(iqProducer, iqConsumer);
+		double timeOQ = runPair(oqProducer, oqConsumer);
+
+		if (r == 0 || timeIQ < bestIQ)
+			bestIQ = timeIQ;
+
+		if (r == 0 || timeOQ < bestOQ)
+			bestOQ = timeOQ;
+	}
+
+	printf("Input Queue: %f sec (%.2f M entries/sec)\n", bestIQ, numOfItems / bestIQ / 1e6);
+	printf("Output Queue: %f sec (%.2f M entries/sec)\n", bestOQ, numOfItems / bestOQ / 1e6);
+	printf("@@ %f %f\n", bestIQ, bestOQ);
+
+	delete inputQueue;
+	delete outputQueue;
+
+	return 0;
+}
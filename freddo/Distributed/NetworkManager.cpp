@@ -221,9 +221,27 @@ void* NetworkManager::run(void* arg) {
 	GASAddress gasAddr;
 	ReceivedSegmentInfo receivedSegInfo;
 
+	// The idle policy of the receiving thread. The MPI_Recv of most MPI libraries busy-polls, thus we poll with MPI_Test
+	// if the threads are allowed to yield or park.
+	const IdlePolicy& idlePolicy = tsuRef->getIdlePolicy();
+	bool pollReceives = idlePolicy.parkingEnabled || idlePolicy.yieldIterations > 0;
+	MPI_Request request;
+	int isReceived;
+	IdleBackoff backoff;
+
 	while (true) {
 		// We are receiving general packet from any peer
-		MPI_Recv((void*) &data, sizeof(GeneralPacket), MPI_BYTE, MPI_ANY_SOURCE, MpiTag::TAG_GENERAL_PACKET, MPI_COMM_WORLD, &status);
+		if (pollReceives) {
+			MPI_Irecv((void*) &data, sizeof(GeneralPacket), MPI_BYTE, MPI_ANY_SOURCE, MpiTag::TAG_GENERAL_PACKET, MPI_COMM_WORLD, &request);
+			MPI_Test(&request, &isReceived, &status);
+
+			for (backoff.reset(); !isReceived; MPI_Test(&request, &isReceived, &status))
+				backoff.idle(idlePolicy);
+		}
+		else {
+			MPI_Recv((void*) &data, sizeof(GeneralPacket), MPI_BYTE, MPI_ANY_SOURCE, MpiTag::TAG_GENERAL_PACKET, MPI_COMM_WORLD, &status);
+		}
+
 		id = status.MPI_SOURCE;  // Get the source (the peer id) of the General Packet
 
 #ifdef NETWORK_STATISTICS
@@ -428,6 +446,9 @@ void* NetworkManager::run(void* arg) {
 			net->setPeerColor(TerminationColor::BLACK);
 		}
 
+		// The TSU may be parked waiting for the new updates or for the termination token
+		tsuRef->wakeUp();
+
 	}  // End of while
 
 	return NULL;
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Doorbell.h
+ *
+ * Description: Implements the idle policy of the runtime threads (Kernels, TSU and Network Manager).
+ * An idle thread spins for a number of iterations, then it yields the core for a number of iterations and finally
+ * it parks on its Doorbell (a futex) until another thread rings it or a timeout expires.
+ *
+ *  Notes:
+ *  	- The thread that makes work available rings the Doorbell only if the parking is enabled, thus
+ *  	  the policy costs nothing when the queues are non-empty
+ *  	- The parking has a bounded timeout. As such, a missed ring delays a thread but it never blocks it forever.
+ */
+
+#ifndef DOORBELL_H_
+#define DOORBELL_H_
+
+// Includes
+#include "../ddm_defs.h"
+#include <atomic>
+#include <climits>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// Defining the idle policy of the runtime threads
+typedef struct {
+		UInt spinIterations;  // The number of idle iterations in which the thread busy-waits
+		UInt yieldIterations;  // The number of idle iterations in which the thread yields its core (after the spinning)
+		bool parkingEnabled;  // Indicates if the thread parks on its Doorbell after the spinning and the yielding
+		UInt parkTimeout;  // The maximum time (in microseconds) that a thread stays parked
+} IdlePolicy;
+
+class Doorbell {
+	public:
+
+		/**
+		 * Creates a Doorbell
+		 */
+		Doorbell() {
+			m_sequence.store(0, std::memory_order_relaxed);
+			m_sleeping.store(false, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Wakes up the thread that is parked on the Doorbell (if any)
+		 * @note call this function after making the work available and only if the parking is enabled
+		 */
+		inline void ring() {
+			// Pairs with the fence of park(): either the parked thread sees the new work or we see that it is sleeping
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (m_sleeping.load(std::memory_order_relaxed)) {
+				m_sequence.fetch_add(1, std::memory_order_release);
+				syscall(SYS_futex, reinterpret_cast<int*>(&m_sequence), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+			}
+		}
+
+		/**
+		 * Parks the calling thread until the Doorbell rings or the timeout expires
+		 * @param[in] hasWork returns true if there is work for the calling thread. It is checked after announcing the sleep.
+		 * @param[in] timeout the maximum time (in microseconds) that the thread stays parked
+		 */
+		template <typename Func>
+		inline void park(Func hasWork, UInt timeout) {
+			UInt sequence = m_sequence.load(std::memory_order_acquire);
+			m_sleeping.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (!hasWork()) {
+				struct timespec ts;
+				ts.tv_sec = timeout / 1000000;
+				ts.tv_nsec = (timeout % 1000000) * 1000;
+				syscall(SYS_futex, reinterpret_cast<int*>(&m_sequence), FUTEX_WAIT_PRIVATE, sequence, &ts, nullptr, 0);
+			}
+
+			m_sleeping.store(false, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @return true if a thread is parked on the Doorbell
+		 */
+		inline bool isSleeping() const {
+			return m_sleeping.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<UInt> m_sequence;  // The futex word. It is increased every time the Doorbell rings a parked thread.
+		std::atomic<bool> m_sleeping;  // Indicates if a thread is parked (or it is going to be parked) on the Doorbell
+};
+
+class IdleBackoff {
+	public:
+
+		/**
+		 * Creates an IdleBackoff
+		 */
+		IdleBackoff() {
+			m_iterations = 0;
+		}
+
+		/**
+		 * Resets the backoff. Call this function when the thread finds work.
+		 */
+		inline void reset() {
+			m_iterations = 0;
+		}
+
+		/**
+		 * Performs one idle iteration according to the idle policy, i.e. spins, yields or parks the calling thread
+		 * @param[in] policy the idle policy
+		 * @param[in] doorbell the Doorbell of the calling thread
+		 * @param[in] hasWork returns true if there is work for the calling thread
+		 */
+		template <typename Func>
+		inline void idle(const IdlePolicy& policy, Doorbell& doorbell, Func hasWork) {
+			if (m_iterations < policy.spinIterations) {
+				m_iterations++;
+#if defined(__x86_64__) || defined(__i386__)
+				__builtin_ia32_pause();
+#endif
+			}
+			else if (m_iterations - policy.spinIterations < policy.yieldIterations) {
+				m_iterations++;
+				sched_yield();
+			}
+			else if (policy.parkingEnabled) {
+				doorbell.park(hasWork, policy.parkTimeout);
+			}
+			else {
+				sched_yield();
+			}
+		}
+
+		/**
+		 * Performs one idle iteration for a thread that cannot be woken up by a Doorbell (e.g. when polling MPI).
+		 * The parking is replaced by sleeping for the park timeout.
+		 * @param[in] policy the idle policy
+		 */
+		inline void idle(const IdlePolicy& policy) {
+			if (m_iterations < policy.spinIterations) {
+				m_iterations++;
+#if defined(__x86_64__) || defined(__i386__)
+				__builtin_ia32_pause();
+#endif
+			}
+			else if (m_iterations - policy.spinIterations < policy.yieldIterations || !policy.parkingEnabled) {
+				m_iterations++;
+				sched_yield();
+			}
+			else {
+				usleep(policy.parkTimeout);
+			}
+		}
+
+	private:
+		UInt m_iterations;  // The number of the consecutive idle iterations
+};
+
+#endif /* DOORBELL_H_ */
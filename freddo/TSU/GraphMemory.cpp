@@ -34,6 +34,55 @@ GraphMemory::GraphMemory()
 
 GraphMemory::~GraphMemory()
 {
+	delete[] m_consumers;
+	delete[] m_offsets;
+}
+
+/**
+ * Builds the read-only CSR copy of the graph
+ * @note call this function when no DThread is executed, i.e. before the DDM scheduling starts
+ */
+void GraphMemory::finalize()
+{
+	TID maxTID = 0;
+	UInt numOfConsumers = 0;
+
+	// The graph is not modified since the last call, e.g. when the same graph is executed repeatedly
+	if (m_isFinalized)
+		return;
+
+	for (auto& x : m_graph) {
+		if (x.first > maxTID)
+			maxTID = x.first;
+
+		numOfConsumers += x.second.size();
+	}
+
+	delete[] m_consumers;
+	delete[] m_offsets;
+
+	m_offsetsSize = maxTID + 1;
+
+	try {
+		m_consumers = new TID[numOfConsumers > 0 ? numOfConsumers : 1];
+		m_offsets = new UInt[m_offsetsSize + 1]();
+	}
+	catch (std::bad_alloc&) {
+		printf("Error while finalizing the Graph Memory => Memory allocation failed\n");
+		exit(ERROR);
+	}
+
+	// Count the consumers of each DThread and compute the offsets (prefix sum)
+	for (auto& x : m_graph)
+		m_offsets[x.first + 1] = x.second.size();
+
+	for (TID tid = 0; tid < m_offsetsSize; ++tid)
+		m_offsets[tid + 1] += m_offsets[tid];
+
+	// Copy the Consumer Lists
+	for (auto& x : m_graph)
+		std::copy(x.second.begin(), x.second.end(), m_consumers + m_offsets[x.first]);
 
+	m_isFinalized = true;
 }
 
@@ -25,13 +25,22 @@
  *      Author: geomat
  *
  *  Description: This class holds the consumers of each DThread
+ *
+ *  Notes:
+ *  	- The Consumer Lists are stored in a hash map while the dependency graph is built
+ *  	- When the graph is finalized, a read-only copy in the Compressed Sparse Row (CSR) format is built: one array with the
+ *  	  consumers of all DThreads and one array of offsets that is indexed by the TIDs. The updates of the consumers use this copy.
+ *  	- Any change after the finalization invalidates the CSR copy until the graph is finalized again
  */
 
 #ifndef GRAPHMEMORY_H_
 #define GRAPHMEMORY_H_
 
 #include "../ddm_defs.h"
+#include "../Error.h"
 #include <unordered_map>
+#include <algorithm>
+#include <new>
 #include <vector>
 
 // Definitions
@@ -51,6 +60,7 @@ class GraphMemory
 		 */
 		inline void insert(TID tid, const ConsumerList consumers)
 		    {
+			m_isFinalized = false;
 			auto got = m_graph.find(tid);
 
 			if (got == m_graph.end())
@@ -64,6 +74,7 @@ class GraphMemory
 		 * @param tid the Thread ID of the DThread
 		 */
 		inline void remove(TID tid) {
+			m_isFinalized = false;
 			m_graph.erase(tid);
 		}
 
@@ -79,6 +90,36 @@ class GraphMemory
 				return &(got->second);
 		}
 
+		/**
+		 * Retrieves the consumers of a DThread from the CSR copy of the graph, or from the hash map if the graph is not finalized
+		 * @param[in] tid the DThread's TID
+		 * @param[out] consumers a pointer to the first consumer
+		 * @return the number of the consumers
+		 */
+		inline UInt getConsumerArray(TID tid, const TID** consumers) const {
+			if (m_isFinalized) {
+				if (tid >= m_offsetsSize)
+					return 0;
+
+				*consumers = m_consumers + m_offsets[tid];
+				return m_offsets[tid + 1] - m_offsets[tid];
+			}
+
+			auto got = m_graph.find(tid);
+
+			if (got == m_graph.end())
+				return 0;
+
+			*consumers = got->second.data();
+			return got->second.size();
+		}
+
+		/**
+		 * Builds the read-only CSR copy of the graph
+		 * @note call this function when no DThread is executed, i.e. before the DDM scheduling starts
+		 */
+		void finalize();
+
 		std::unordered_map<TID, ConsumerList>::iterator begin()
 		{
 			return m_graph.begin();
@@ -91,6 +132,10 @@ class GraphMemory
 
 	private:
 		std::unordered_map<TID, ConsumerList> m_graph;  // Holds the Consumers of each DThread
+		TID* m_consumers = nullptr;  // The consumers of all DThreads (CSR copy). The consumers of a DThread are stored consecutively.
+		UInt* m_offsets = nullptr;  // The consumers of DThread tid are from m_offsets[tid] up to m_offsets[tid + 1] - 1 (CSR copy)
+		TID m_offsetsSize = 0;  // The number of the DThreads that are covered by the offsets, i.e. the largest TID plus one
+		bool m_isFinalized = false;  // Indicates if the CSR copy is up to date
 };
 
 #endif /* GRAPHMEMORY_H_ */
@@ -12,8 +12,10 @@
  *	Creates an Input Queue
  */
 InputQueue::InputQueue() {
-	m_head = 0;
-	m_tail = 0;
+	m_head.store(0, std::memory_order_relaxed);
+	m_tail.store(0, std::memory_order_relaxed);
+	m_cachedHead = 0;
+	m_cachedTail = 0;
 }
 
 /**
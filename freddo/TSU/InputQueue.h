@@ -28,6 +28,9 @@
  *
  *  Notes:
  *  	- The Input Queue is abbreviated as IQ
+ *  	- This queue is a wait-free and lock-free implementation which is intended for use by a single consumer-thread (the TSU) and a single producer-thread (a Kernel)
+ *  	- The head and the tail are published with release stores and read with acquire loads. They are kept in different cache lines.
+ *  	- Each side caches the index of the other side and re-reads it only when the queue seems to be full (producer) or empty (consumer)
  *  	- In this queue implementation one entry is always unused
  */
 
@@ -36,16 +39,44 @@
 
 // Includes
 #include "../ddm_defs.h"
-
-// Defining the IQ entry
+#include <atomic>
+
+// The types of the IQ entries
+typedef enum {
+	IQ_SINGLE_UPDATE,  // Decrements the Ready Count of one instance
+	IQ_MULTIPLE_UPDATE,  // Decrements the Ready Counts of a range of instances
+	IQ_READY_INSTANCE,  // The instance is already ready for execution (its Ready Count is updated by a Kernel). It is only scheduled.
+	IQ_MULTICAST_UPDATE,  // Decrements the Ready Count of one instance of each consumer of the DThread (tid is the producer)
+	IQ_MULTICAST_MULTIPLE_UPDATE  // Decrements the Ready Counts of a range of instances of each consumer of the DThread (tid is the producer)
+} IQEntryType;
+
+// Defining the IQ entry. This is the unpacked form of an entry which is used outside of the Input Queue.
 typedef struct {
-		bool isMultiple;  // Indicates if the Update is for multiple contexts
+		IQEntryType type;  // The type of the entry
 		TID tid;  // The DThread's identity
 		context_t context;  // The DThread's context
 		context_t maxContext;  // The maximum context of a DThread. It is used on multiple updates.
 		void* data = nullptr;  // Data that are used for the update. Currently, it's used only for the arguments of a recursive function
 } IQ_Entry;
 
+// The type of an IQ slot is tagged with this flag if the entry has an extension in the side lane of the queue
+#define IQ_EXTENDED_ENTRY 0x80U
+
+/* Defining a slot of the Input Queue. It holds the fields of an update of a single context without data, i.e. the most common entries
+ * (16 bytes with the 64-bit Contexts). The rest fields of the multiple updates and of the updates with data are stored in the side lane.
+ */
+typedef struct {
+		UInt type;  // The type of the entry (IQEntryType) and the IQ_EXTENDED_ENTRY flag
+		TID tid;  // The DThread's identity
+		context_t context;  // The DThread's context
+} IQ_Slot;
+
+// Defining the extension of an IQ slot. It is stored in the side lane of the queue, at the same index as the slot.
+typedef struct {
+		context_t maxContext;  // The maximum context of a DThread. It is used on multiple updates.
+		void* data;  // Data that are used for the update
+} IQ_SlotExtension;
+
 /* We use the bitwise_and operation instead of modulo to increase the performance.
  * Notice that the IQ_SIZE has to be in the power of 2.
  * The formula is as follows: X % NUMBER == X & (NUMBER-1)
@@ -69,24 +100,16 @@ class InputQueue {
 		 @return true if the Input Queue is empty
 		 */
 		inline bool isEmpty(void) const {
-			return (m_head == m_tail);
+			return (m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire));
 		}
 
 		/**
 		 @return true if the Input Queue is full
 		 */
 		inline bool isFull(void) const {
-			const UInt next_tail = INCR_IQ_INDX(m_tail);
+			const UInt next_tail = INCR_IQ_INDX(m_tail.load(std::memory_order_acquire));
 
-			return (next_tail == m_head);
-		}
-
-		/**
-		 Returns the Input Queue's head but does not remove the element
-		 @return a pointer to the head of the queue
-		 */
-		inline const IQ_Entry* peekHead(void) const {
-			return (m_entries + m_head);
+			return (next_tail == m_head.load(std::memory_order_acquire));
 		}
 
 		/**
@@ -98,20 +121,7 @@ class InputQueue {
 		 @note Push on tail. The tail is only changed by producer (the Kernel)
 		 */
 		inline bool enqueue(TID tid, context_t context, context_t maxContext) {
-			UInt curHead = m_head;  // Storing head in order to avoid queue full state if we remove the item from the queue immediately after we put it
-			UInt next_tail = INCR_IQ_INDX(m_tail);
-
-			if (next_tail != curHead) {
-				m_entries[m_tail].tid = tid;
-				m_entries[m_tail].context = context;
-				m_entries[m_tail].maxContext = maxContext;
-				m_entries[m_tail].isMultiple = true;
-
-				m_tail = next_tail;  // Move to the next free entry
-				return true;
-			}
-
-			return false;  // The queue is full
+			return enqueueSlot(IQ_MULTIPLE_UPDATE, tid, context, true, maxContext, nullptr);
 		}
 
 		/**
@@ -122,19 +132,7 @@ class InputQueue {
 		 @note Push on tail. The tail is only changed by producer (the Kernel)
 		 */
 		inline bool enqueue(TID tid, context_t context) {
-			UInt curHead = m_head;  // Storing head in order to avoid queue full state if we remove the item from the queue immediately after we put it
-			UInt next_tail = INCR_IQ_INDX(m_tail);
-
-			if (next_tail != curHead) {
-				m_entries[m_tail].tid = tid;
-				m_entries[m_tail].context = context;
-				m_entries[m_tail].isMultiple = false;
-
-				m_tail = next_tail;  // Move to the next free entry
-				return true;
-			}
-
-			return false;  // The queue is full
+			return enqueueSlot(IQ_SINGLE_UPDATE, tid, context, false, context, nullptr);
 		}
 
 		/**
@@ -146,20 +144,46 @@ class InputQueue {
 		 @note Push on tail. The tail is only changed by producer (the Kernel)
 		 */
 		inline bool enqueue(TID tid, RInstance instance, void* data) {
-			UInt curHead = m_head;  // Storing head in order to avoid queue full state if we remove the item from the queue immediately after we put it
-			UInt next_tail = INCR_IQ_INDX(m_tail);
+			const context_t context = CREATE_N1(instance);
 
-			if (next_tail != curHead) {
-				m_entries[m_tail].tid = tid;
-				m_entries[m_tail].context = CREATE_N1(instance);
-				m_entries[m_tail].isMultiple = false;
-				m_entries[m_tail].data = data;
+			return enqueueSlot(IQ_SINGLE_UPDATE, tid, context, data != nullptr, context, data);
+		}
 
-				m_tail = next_tail;  // Move to the next free entry
-				return true;
-			}
+		/**
+		 Enqueue an IQ entry for an instance that is already ready for execution.
+		 @param[in] tid the DThread's ID
+		 @param[in] context the context of the ready instance
+		 @param[in] data the pointer to the data of the DThread
+		 @return true if the enqueue was completed or false if the queue was full
+		 @note Push on tail. The tail is only changed by producer (the Kernel)
+		 */
+		inline bool enqueueReady(TID tid, context_t context, void* data) {
+			return enqueueSlot(IQ_READY_INSTANCE, tid, context, data != nullptr, context, data);
+		}
 
-			return false;  // The queue is full
+		/**
+		 Enqueue an IQ entry that updates all the consumers of a DThread. The TSU expands it using the Graph Memory.
+		 @param[in] tid the DThread's ID whose consumers we want to update
+		 @param[in] context the context of the consumers or the start of the context range
+		 @param[in] maxContext the end of the context range. It is ignored if isRange is false.
+		 @param[in] isRange indicates if the entry updates a range of instances of each consumer
+		 @return true if the enqueue was completed or false if the queue was full
+		 @note Push on tail. The tail is only changed by producer (the Kernel)
+		 */
+		inline bool enqueueMulticast(TID tid, context_t context, context_t maxContext, bool isRange) {
+			return enqueueSlot(isRange ? IQ_MULTICAST_MULTIPLE_UPDATE : IQ_MULTICAST_UPDATE, tid, context, isRange, maxContext, nullptr);
+		}
+
+		/**
+		 Enqueue a copy of an IQ entry of any type
+		 @param[in] entry the IQ entry
+		 @return true if the enqueue was completed or false if the queue was full
+		 @note Push on tail. The tail is only changed by producer (the Kernel)
+		 */
+		inline bool enqueue(const IQ_Entry& entry) {
+			const bool isExtended = entry.data != nullptr || entry.type == IQ_MULTIPLE_UPDATE || entry.type == IQ_MULTICAST_MULTIPLE_UPDATE;
+
+			return enqueueSlot(entry.type, entry.tid, entry.context, isExtended, entry.maxContext, entry.data);
 		}
 
 		/**
@@ -169,33 +193,125 @@ class InputQueue {
 		 * @note Only the consumer (the TSU) can change the head
 		 */
 		inline bool dequeue(IQ_Entry* const item) {
-			if (m_head == m_tail)
+			const UInt head = m_head.load(std::memory_order_relaxed);
+
+			if (head == m_cachedTail && head == (m_cachedTail = m_tail.load(std::memory_order_acquire)))
 				return false;  // The queue is empty
 
-			*item = m_entries[m_head];
-			m_head = INCR_IQ_INDX(m_head);
+			unpackSlot(head, item);
+			m_head.store(INCR_IQ_INDX(head), std::memory_order_release);
 
 			return true;
 		}
 
+		/**
+		 * Dequeue up to maxItems IQ entries. The head is published once for the whole batch.
+		 * @param[out] items the buffer that will be filled with the dequeued entries
+		 * @param[in] maxItems the maximum number of entries that will be dequeued
+		 * @return the number of the dequeued entries
+		 * @note Only the consumer (the TSU) can change the head
+		 */
+		inline UInt dequeue(IQ_Entry* const items, UInt maxItems) {
+			UInt head = m_head.load(std::memory_order_relaxed);
+			UInt count = 0;
+
+			if (head == m_cachedTail)
+				m_cachedTail = m_tail.load(std::memory_order_acquire);
+
+			while (head != m_cachedTail && count < maxItems) {
+				unpackSlot(head, &items[count++]);
+				head = INCR_IQ_INDX(head);
+			}
+
+			if (count)
+				m_head.store(head, std::memory_order_release);
+
+			return count;
+		}
+
 		/**
 		 * Remove the head of the Input Queue
 		 * @return true if the dequeue was completed or false if the queue was empty
 		 * @note Only the consumer can change the head
 		 */
 		inline bool popHead(void) {
-			if (m_head == m_tail)
+			const UInt head = m_head.load(std::memory_order_relaxed);
+
+			if (head == m_cachedTail && head == (m_cachedTail = m_tail.load(std::memory_order_acquire)))
 				return false;  // The queue is empty
 
-			m_head = INCR_IQ_INDX(m_head);
+			m_head.store(INCR_IQ_INDX(head), std::memory_order_release);
 
 			return true;
 		}
 
 	private:
-		IQ_Entry m_entries[IQ_SIZE];  // The entries of the queue
-		volatile UInt m_head;  // Points to the head (front) of the queue
-		volatile UInt m_tail;  // Points to the tail (rear) of the queue
+		// The consumer's cache line
+		std::atomic<UInt> m_head;  // Points to the head (front) of the queue. It is only changed by the consumer.
+		UInt m_cachedTail;  // The consumer's copy of the tail
+		char m_padHead[CACHE_LINE_SIZE - sizeof(std::atomic<UInt>) - sizeof(UInt)];  // Keeps the head and the tail in different cache lines
+
+		// The producer's cache line
+		std::atomic<UInt> m_tail;  // Points to the tail (rear) of the queue. It is only changed by the producer.
+		UInt m_cachedHead;  // The producer's copy of the head
+		char m_padTail[CACHE_LINE_SIZE - sizeof(std::atomic<UInt>) - sizeof(UInt)];  // Keeps the tail and the entries in different cache lines
+
+		IQ_Slot m_slots[IQ_SIZE];  // The entries of the queue
+		IQ_SlotExtension m_extensions[IQ_SIZE];  // The side lane. It is only accessed for the slots with the IQ_EXTENDED_ENTRY flag.
+
+		/**
+		 Stores an entry in the tail slot of the queue
+		 @param[in] type the type of the entry
+		 @param[in] tid the DThread's ID
+		 @param[in] context the context of the entry
+		 @param[in] isExtended indicates if the maximum context and the data are stored in the side lane
+		 @param[in] maxContext the end of the context range
+		 @param[in] data the data of the entry
+		 @return true if the enqueue was completed or false if the queue was full
+		 */
+		inline bool enqueueSlot(IQEntryType type, TID tid, const context_t& context, bool isExtended, const context_t& maxContext, void* data) {
+			const UInt tail = m_tail.load(std::memory_order_relaxed);
+			const UInt next_tail = INCR_IQ_INDX(tail);
+
+			if (next_tail != m_cachedHead || next_tail != (m_cachedHead = m_head.load(std::memory_order_acquire))) {
+				IQ_Slot& slot = m_slots[tail];
+				slot.type = isExtended ? (type | IQ_EXTENDED_ENTRY) : type;
+				slot.tid = tid;
+				slot.context = context;
+
+				if (isExtended) {
+					m_extensions[tail].maxContext = maxContext;
+					m_extensions[tail].data = data;
+				}
+
+				m_tail.store(next_tail, std::memory_order_release);  // Move to the next free entry and publish it
+				return true;
+			}
+
+			return false;  // The queue is full
+		}
+
+		/**
+		 Unpacks a slot of the queue
+		 @param[in] index the index of the slot
+		 @param[out] item the IQ entry that will be filled with the slot's value
+		 */
+		inline void unpackSlot(UInt index, IQ_Entry* const item) const {
+			const IQ_Slot& slot = m_slots[index];
+
+			item->type = (IQEntryType) (slot.type & ~IQ_EXTENDED_ENTRY);
+			item->tid = slot.tid;
+			item->context = slot.context;
+
+			if (slot.type & IQ_EXTENDED_ENTRY) {
+				item->maxContext = m_extensions[index].maxContext;
+				item->data = m_extensions[index].data;
+			}
+			else {
+				item->maxContext = slot.context;
+				item->data = nullptr;
+			}
+		}
 };
 
 #endif /* INPUTQUEUE_H_ */
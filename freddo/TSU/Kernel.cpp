@@ -31,9 +31,14 @@
  * Creates a Kernel
  * @param[in] kernelID the Kernel's unique identifier
  * @param[in] numofPeers the number of peers of the distributed system
+ * @param[in] pendingInDeques counts the instances that are inserted in the Work-Stealing Deques of the Kernels and they are not executed yet
+ * @param[in] idlePolicy the idle policy of the Kernel
  */
-Kernel::Kernel(KernelID kernelID, UInt numofPeers) {
+Kernel::Kernel(KernelID kernelID, UInt numofPeers, std::atomic<UInt>* pendingInDeques, const IdlePolicy* idlePolicy) {
 	m_kernelID = kernelID;
+	m_pendingInDeques = pendingInDeques;
+	m_idlePolicy = idlePolicy;
+	m_randomState = 2463534242U + kernelID;  // The seed of the Xorshift generator should not be zero
 	m_isFinished = true;
 	m_pthreadID = 0;
 
@@ -86,60 +91,65 @@ void* Kernel::run(void* arg) {
 	Kernel* kernel = (Kernel*) arg;
 	//KernelID kernelID = kernel->m_kernelID;
 	OutputQueue* oq = &kernel->m_outputQueue;
-	const OQ_Entry* oqEntry;
+	WorkStealingDeque* deque = &kernel->m_deque;
+	std::atomic<UInt>* pendingInDeques = kernel->m_pendingInDeques;
 	volatile bool* m_isKernelFinished = &kernel->m_isFinished;
-	ContextArg context;
-	Context2D context2D;
-	Context3D context3D;
 	DataForwardTable* dft = kernel->m_dataForwardTable;
+	bool workStealing = (kernel->m_kernels != nullptr);
+	OQ_Entry entry;
+	const IdlePolicy* idlePolicy = kernel->m_idlePolicy;
+	IdleBackoff backoff;
+	bool isBusy = false;  // Indicates if the Kernel executed DThreads since the last time it was idle
+
+	// The DThreads find the Kernel that executes them through this thread-local variable
+	threadKernelID() = kernel->m_kernelID;
 
 	do {
+		// The instances with priority are executed before any other instance
+		if (kernel->executePriorityDThread(dft)) {
+			isBusy = true;
+		}
+		// The instances of the deque are executed next, since the instances that became ready by this Kernel have their data in the Kernel's cache
+		else if (deque->pop(&entry) || (workStealing && oq->isEmpty() && kernel->stealDThread(&entry))) {
+			// Leave the rest of the range to the thieves and to the next iterations
+			if (entry.isRange)
+				kernel->splitLocalRange(&entry);
+
+			executeDThread(&entry, dft);
+			pendingInDeques->fetch_sub(1);
+			isBusy = true;
+		}
 		// Dequeue a ready DThread from the Output Queue, if the queue is not empty
-		if (!oq->isEmpty()) {
+		else if (!oq->isEmpty()) {
+			// Make the ready DThreads available to the thieves. The pinned head (or the head that does not fit in the full deque) is executed here.
+			if (workStealing && kernel->transferOutputQueue() > 0)
+				continue;
 
-			oqEntry = oq->peekHead();
 			//SAFE_LOG("Executing DThread in kernel " << kernel->getKernelID());
+			oq->peekHead(&entry);
 
-			// Execute the proper DFunction according to the Nesting Attribute
-			switch (oqEntry->nesting) {
-				case Nesting::ONE:
-					context = GET_N1(oqEntry->context);
-					oqEntry->ifp->multipleDFunction(context);
-					break;
-
-				case Nesting::TWO:
-					context2D.Outer = (cntx_2D_Out_t) GET_N2_OUTER(oqEntry->context);
-					context2D.Inner = (cntx_2D_In_t) GET_N2_INNER(oqEntry->context);
-					oqEntry->ifp->multipleDFunction2D(context2D);
-					break;
-
-				case Nesting::THREE:
-					context3D.Outer = GET_N3_OUTER(oqEntry->context);
-					context3D.Middle = GET_N3_MIDDLE(oqEntry->context);
-					context3D.Inner = GET_N3_INNER(oqEntry->context);
-					oqEntry->ifp->multipleDFunction3D(context3D);
-					break;
-
-				case Nesting::RECURSIVE:
-					context = GET_N1(oqEntry->context);
-					oqEntry->ifp->recursiveDFunction(context, oqEntry->data);
-					break;
-
-				case Nesting::ZERO:
-					oqEntry->ifp->simpleDFunction();
-					break;
-
-				case Nesting::CONTINUATION:
-					context = GET_N1(oqEntry->context);
-					oqEntry->ifp->continuationDFunction(context, oqEntry->data);
-					break;
-			}
-
+			kernel->m_isExecutingQueueHead = true;
+			executeDThread(&entry, dft);
 			oq->popHead();
+			kernel->m_isExecutingQueueHead = false;
+			isBusy = true;
+		}
+		else {
+			// The Kernel became idle. Let the TSU check if the execution is finished.
+			if (isBusy) {
+				if (idlePolicy->parkingEnabled) {
+					kernel->m_tsuDoorbell->ring();
+
+					// The TSU thread that fills the Output Queues may wait for free space (Ready Backlog)
+					if (kernel->m_ownerDoorbell != kernel->m_tsuDoorbell)
+						kernel->m_ownerDoorbell->ring();
+				}
+
+				backoff.reset();
+				isBusy = false;
+			}
 
-			// If DFT is not null, i.e. we are in distributed mode, clear the DFT
-			if (dft)
-				dft->clear();
+			backoff.idle(*idlePolicy, kernel->m_doorbell, [&]() {return !kernel->isOutputQueueEmpty() || !deque->isEmpty() || *m_isKernelFinished;});
 		}
 	}
 	while (!*m_isKernelFinished);
@@ -147,3 +157,92 @@ void* Kernel::run(void* arg) {
 	return NULL;
 }
 
+/**
+ * Executes the DFunction of a ready DThread according to its Nesting Attribute
+ * @param[in] oqEntry the ready DThread. If it holds a range, all the instances of the range are executed.
+ * @param[in] dft the Data Forward Table of the Kernel. It is cleared after the execution of each instance (distributed mode).
+ */
+void Kernel::executeDThread(const OQ_Entry* oqEntry, DataForwardTable* dft) {
+	if (!oqEntry->isRange) {
+		executeInstance(oqEntry, oqEntry->context, dft);
+		return;
+	}
+
+	const context_t& context = oqEntry->context;
+	const context_t& maxContext = oqEntry->maxContext;
+
+	switch (oqEntry->nesting) {
+		case Nesting::ONE:
+			for (cntx_1D_t cntxInn = GET_N1(context); cntxInn < (GET_N1(maxContext) + 1U); ++cntxInn)
+				executeInstance(oqEntry, CREATE_N1(cntxInn), dft);
+			break;
+
+		case Nesting::TWO:
+			for (cntx_2D_Out_t cntxOut = GET_N2_OUTER(context); cntxOut < (GET_N2_OUTER(maxContext) + 1U); ++cntxOut)
+				for (cntx_2D_In_t cntxInn = GET_N2_INNER(context); cntxInn < (GET_N2_INNER(maxContext) + 1U); ++cntxInn)
+					executeInstance(oqEntry, CREATE_N2(cntxOut, cntxInn), dft);
+			break;
+
+		case Nesting::THREE:
+			for (cntx_3D_Out_t cntxOut = GET_N3_OUTER(context); cntxOut < (GET_N3_OUTER(maxContext) + 1U); ++cntxOut)
+				for (cntx_3D_Mid_t cntxMid = GET_N3_MIDDLE(context); cntxMid < (GET_N3_MIDDLE(maxContext) + 1U); ++cntxMid)
+					for (cntx_3D_In_t cntxInn = GET_N3_INNER(context); cntxInn < (GET_N3_INNER(maxContext) + 1U); ++cntxInn)
+						executeInstance(oqEntry, CREATE_N3(cntxOut, cntxMid, cntxInn), dft);
+			break;
+
+		default:
+			// Only the DThreads with Nesting 1, 2 and 3 are scheduled in ranges
+			break;
+	}
+}
+
+/**
+ * Executes the DFunction of a ready DThread's instance according to its Nesting Attribute
+ * @param[in] oqEntry the ready DThread
+ * @param[in] instance the context of the instance
+ * @param[in] dft the Data Forward Table of the Kernel or null if we are in the single node execution
+ */
+void Kernel::executeInstance(const OQ_Entry* oqEntry, context_t instance, DataForwardTable* dft) {
+	ContextArg context;
+	Context2D context2D;
+	Context3D context3D;
+
+	// Execute the proper DFunction according to the Nesting Attribute
+	switch (oqEntry->nesting) {
+		case Nesting::ONE:
+			context = GET_N1(instance);
+			oqEntry->ifp->multipleDFunction(context);
+			break;
+
+		case Nesting::TWO:
+			context2D.Outer = (cntx_2D_Out_t) GET_N2_OUTER(instance);
+			context2D.Inner = (cntx_2D_In_t) GET_N2_INNER(instance);
+			oqEntry->ifp->multipleDFunction2D(context2D);
+			break;
+
+		case Nesting::THREE:
+			context3D.Outer = GET_N3_OUTER(instance);
+			context3D.Middle = GET_N3_MIDDLE(instance);
+			context3D.Inner = GET_N3_INNER(instance);
+			oqEntry->ifp->multipleDFunction3D(context3D);
+			break;
+
+		case Nesting::RECURSIVE:
+			context = GET_N1(instance);
+			oqEntry->ifp->recursiveDFunction(context, oqEntry->data);
+			break;
+
+		case Nesting::ZERO:
+			oqEntry->ifp->simpleDFunction();
+			break;
+
+		case Nesting::CONTINUATION:
+			context = GET_N1(instance);
+			oqEntry->ifp->continuationDFunction(context, oqEntry->data);
+			break;
+	}
+
+	// If DFT is not null, i.e. we are in distributed mode, clear the DFT
+	if (dft)
+		dft->clear();
+}
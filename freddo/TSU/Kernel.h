@@ -34,9 +34,12 @@
 #include <pthread.h>
 #include "../Auxiliary.h"
 #include "OutputQueue.h"
+#include "WorkStealingDeque.h"
+#include "Doorbell.h"
 #include "../Logging.h"
 #include "../Error.h"
 #include "../Distributed/DataForwardTable.h"
+#include <atomic>
 
 using namespace std;
 
@@ -47,14 +50,25 @@ class Kernel {
 		 * Creates a Kernel
 		 * @param[in] kernelID the Kernel's unique identifier
 		 * @param[in] numofPeers the number of peers of the distributed system
+		 * @param[in] pendingInDeques counts the instances that are inserted in the Work-Stealing Deques of the Kernels and they are not executed yet
+		 * @param[in] idlePolicy the idle policy of the Kernel
 		 */
-		Kernel(KernelID kernelID, UInt numofPeers);
+		Kernel(KernelID kernelID, UInt numofPeers, std::atomic<UInt>* pendingInDeques, const IdlePolicy* idlePolicy);
 
 		/**
 		 *	Releases the memory allocated by the Kernel
 		 */
 		~Kernel();
 
+		/**
+		 * @return a reference to the KernelID of the calling thread. It is set when a Kernel starts and when FREDDO is initialized (main thread).
+		 * For any other thread it is EXTERNAL_THREAD_ID.
+		 */
+		static inline KernelID& threadKernelID() {
+			static thread_local KernelID kernelID = EXTERNAL_THREAD_ID;
+			return kernelID;
+		}
+
 		/**
 		 * Starts the Kernel
 		 * @param[in] affinity the core on which the Kernel will run
@@ -66,27 +80,244 @@ class Kernel {
 		/**
 		 * Inserts a ready DThread to the Kernel's Output Queue
 		 * @param[in] ifp the pointer of the ready DThread's function
-		 * @param[in] tid the DThread's identifier
 		 * @param[in] context the ready DThread's context
 		 * @param[in] nesting the ready DThread's nesting
-		 * @param[in] nesting the ready DThread's nesting
 		 * @return true if the insertion was completed, otherwise false
 		 */
-		inline bool addReadyDThread(IFP ifp, TID tid, context_t context, Nesting nesting) {
-			return m_outputQueue.enqueue(ifp, tid, context, nesting);
+		inline bool addReadyDThread(IFP ifp, context_t context, Nesting nesting) {
+			if (!m_outputQueue.enqueue(ifp, context, nesting))
+				return false;
+
+			if (m_idlePolicy->parkingEnabled)
+				m_doorbell.ring();
+
+			return true;
 		}
 
 		/**
 		 * Inserts a ready DThread to the Kernel's Output Queue
 		 * @param[in] ifp the pointer of the ready DThread's function
-		 * @param[in] tid the DThread's identifier
 		 * @param[in] context the ready DThread's context
 		 * @param[in] nesting the ready DThread's nesting
 		 * @param[in] data the pointer to the arguments of the DThread
 		 * @return true if the insertion was completed, otherwise false
 		 */
-		inline bool addReadyDThread(IFP ifp, TID tid, context_t context, Nesting nesting, void* data) {
-			return m_outputQueue.enqueue(ifp, tid, context, nesting, data);
+		inline bool addReadyDThread(IFP ifp, context_t context, Nesting nesting, void* data) {
+			if (!m_outputQueue.enqueue(ifp, context, nesting, data))
+				return false;
+
+			if (m_idlePolicy->parkingEnabled)
+				m_doorbell.ring();
+
+			return true;
+		}
+
+		/**
+		 * Inserts a ready DThread (or a range of ready instances) to the Output Queue of its priority level
+		 * @param[in] entry the ready DThread
+		 * @param[in] priority the priority of the ready DThread
+		 * @return true if the insertion was completed, otherwise false
+		 */
+		inline bool addReadyEntry(const OQ_Entry& entry, UInt priority) {
+			OutputQueue& queue = (priority == DEFAULT_PRIORITY) ? m_outputQueue : m_priorityQueues[priority - 1];
+
+			if (!queue.enqueue(entry))
+				return false;
+
+			if (m_idlePolicy->parkingEnabled)
+				m_doorbell.ring();
+
+			return true;
+		}
+
+		/**
+		 * Enables the work-stealing, i.e. the Kernel steals ready DThreads from the Work-Stealing Deques of the other Kernels when it is idle
+		 * @param[in] kernels the Kernels of the TSU
+		 * @param[in] kernelsNum the number of the Kernels
+		 * @note call this function before starting the Kernel
+		 */
+		inline void enableWorkStealing(Kernel** kernels, UInt kernelsNum) {
+			m_kernels = kernels;
+			m_kernelsNum = kernelsNum;
+		}
+
+		/**
+		 * Sets the Doorbells of the TSU threads that the Kernel rings when it becomes idle
+		 * @param[in] tsuDoorbell the Doorbell of the TSU thread that detects the termination
+		 * @param[in] ownerDoorbell the Doorbell of the TSU thread that fills the Kernel's Output Queues
+		 * @note call this function before starting the Kernel
+		 */
+		inline void setTSUDoorbells(Doorbell* tsuDoorbell, Doorbell* ownerDoorbell) {
+			m_tsuDoorbell = tsuDoorbell;
+			m_ownerDoorbell = ownerDoorbell;
+		}
+
+		/**
+		 * Inserts a DThread's instance, which became ready by this Kernel, in the Kernel's Work-Stealing Deque
+		 * @param[in] ifp the pointer of the ready DThread's function
+		 * @param[in] context the ready DThread's context
+		 * @param[in] nesting the ready DThread's nesting
+		 * @param[in] data the pointer to the arguments of the DThread
+		 * @return true if the insertion was completed, otherwise false
+		 * @note only the Kernel itself is allowed to call this function (decentralized updates)
+		 */
+		inline bool addLocalReadyDThread(IFP ifp, context_t context, Nesting nesting, void* data) {
+			m_pendingInDeques->fetch_add(1);
+
+			if (m_deque.push(ifp, context, nesting, data)) {
+				wakeThief();
+				return true;
+			}
+
+			m_pendingInDeques->fetch_sub(1);
+			return false;
+		}
+
+		/**
+		 * Executes a DThread's instance, which became ready by this Kernel, inside the DThread that the Kernel currently executes
+		 * @param[in] ifp the pointer of the ready DThread's function
+		 * @param[in] context the ready DThread's context
+		 * @param[in] nesting the ready DThread's nesting
+		 * @param[in] data the pointer to the arguments of the DThread
+		 * @return false if the inline execution depth is reached, i.e. the instance has to be inserted in a queue
+		 * @note only the Kernel itself is allowed to call this function
+		 */
+		inline bool executeInline(IFP ifp, context_t context, Nesting nesting, void* data) {
+			// The DFT holds the data of the running DThread (distributed mode)
+			if (m_inlineDepth >= m_maxInlineDepth || m_dataForwardTable)
+				return false;
+
+			OQ_Entry entry;
+			entry.ifp = ifp;
+			entry.context = context;
+			entry.nesting = nesting;
+			entry.data = data;
+
+			m_inlineDepth++;
+			executeDThread(&entry, nullptr);
+			m_inlineDepth--;
+
+			return true;
+		}
+
+		/**
+		 * Sets the maximum number of nested DThreads that the Kernel executes inline (see executeInline)
+		 * @param[in] depth the maximum nesting depth. Zero disables the inline execution.
+		 */
+		inline void setInlineExecutionDepth(UInt depth) {
+			m_maxInlineDepth = depth;
+		}
+
+		/**
+		 * Inserts a range of instances, which became ready by this Kernel, in the Kernel's Work-Stealing Deque
+		 * @param[in] ifp the pointer of the ready DThread's function
+		 * @param[in] context the start of the Context
+		 * @param[in] maxContext the end of the Context
+		 * @param[in] nesting the ready DThread's nesting
+		 * @return true if the insertion was completed, otherwise false
+		 * @note only the Kernel itself is allowed to call this function (decentralized updates)
+		 */
+		inline bool addLocalReadyRange(IFP ifp, context_t context, context_t maxContext, Nesting nesting) {
+			OQ_Entry entry;
+			entry.ifp = ifp;
+			entry.context = context;
+			entry.maxContext = maxContext;
+			entry.nesting = nesting;
+			entry.isRange = true;
+
+			m_pendingInDeques->fetch_add(1);
+
+			if (m_deque.push(entry)) {
+				wakeThief();
+				return true;
+			}
+
+			m_pendingInDeques->fetch_sub(1);
+			return false;
+		}
+
+		/**
+		 * Splits a range of instances in two halves. The outermost dimension that holds more than one context is split.
+		 * @param[in,out] range the range. It keeps the lower half after the split.
+		 * @param[out] upper the upper half of the range
+		 * @return false if the range holds a single instance, i.e. it cannot be split
+		 */
+		static inline bool splitRange(OQ_Entry* range, OQ_Entry* upper) {
+			*upper = *range;
+
+			switch (range->nesting) {
+				case Nesting::ONE: {
+					cntx_1D_t from = GET_N1(range->context), to = GET_N1(range->maxContext);
+
+					if (from >= to)
+						return false;
+
+					cntx_1D_t mid = from + (to - from) / 2;
+					range->maxContext = CREATE_N1(mid);
+					upper->context = CREATE_N1(mid + 1);
+					return true;
+				}
+
+				case Nesting::TWO: {
+					cntx_2D_Out_t outFrom = GET_N2_OUTER(range->context), outTo = GET_N2_OUTER(range->maxContext);
+					cntx_2D_In_t innFrom = GET_N2_INNER(range->context), innTo = GET_N2_INNER(range->maxContext);
+
+					if (outFrom < outTo) {
+						cntx_2D_Out_t mid = outFrom + (outTo - outFrom) / 2;
+						range->maxContext = CREATE_N2(mid, innTo);
+						upper->context = CREATE_N2(mid + 1, innFrom);
+						return true;
+					}
+
+					if (innFrom < innTo) {
+						cntx_2D_In_t mid = innFrom + (innTo - innFrom) / 2;
+						range->maxContext = CREATE_N2(outTo, mid);
+						upper->context = CREATE_N2(outFrom, mid + 1);
+						return true;
+					}
+
+					return false;
+				}
+
+				case Nesting::THREE: {
+					cntx_3D_Out_t outFrom = GET_N3_OUTER(range->context), outTo = GET_N3_OUTER(range->maxContext);
+					cntx_3D_Mid_t midFrom = GET_N3_MIDDLE(range->context), midTo = GET_N3_MIDDLE(range->maxContext);
+					cntx_3D_In_t innFrom = GET_N3_INNER(range->context), innTo = GET_N3_INNER(range->maxContext);
+
+					if (outFrom < outTo) {
+						cntx_3D_Out_t mid = outFrom + (outTo - outFrom) / 2;
+						range->maxContext = CREATE_N3(mid, midTo, innTo);
+						upper->context = CREATE_N3(mid + 1, midFrom, innFrom);
+						return true;
+					}
+
+					if (midFrom < midTo) {
+						cntx_3D_Mid_t mid = midFrom + (midTo - midFrom) / 2;
+						range->maxContext = CREATE_N3(outTo, mid, innTo);
+						upper->context = CREATE_N3(outFrom, mid + 1, innFrom);
+						return true;
+					}
+
+					if (innFrom < innTo) {
+						cntx_3D_In_t mid = innFrom + (innTo - innFrom) / 2;
+						range->maxContext = CREATE_N3(outTo, midTo, mid);
+						upper->context = CREATE_N3(outFrom, midFrom, mid + 1);
+						return true;
+					}
+
+					return false;
+				}
+
+				default:
+					return false;
+			}
+		}
+
+		/**
+		 * @return true if the caller is the pthread of this Kernel
+		 */
+		inline bool isCurrentThread() const {
+			return pthread_equal(pthread_self(), m_pthreadID);
 		}
 
 		/**
@@ -104,10 +335,33 @@ class Kernel {
 		}
 
 		/**
-		 * @return true if the Kernel's Output Queue is empty
+		 * @return the number of ready DThreads that are waiting in the Kernel's Output Queue and Work-Stealing Deque
+		 */
+		inline UInt getQueuedDThreads() const {
+			UInt queued = m_outputQueue.getSize() + m_deque.getSize();
+
+			for (UInt i = 0; i < PRIORITY_LEVELS - 1; ++i)
+				queued += m_priorityQueues[i].getSize();
+
+			return queued;
+		}
+
+		/**
+		 * @return true if the Kernel's Output Queues (of all priority levels) are empty
 		 */
 		inline bool isOutputQueueEmpty() const {
-			return m_outputQueue.isEmpty();
+			return m_outputQueue.isEmpty() && !hasPriorityDThreads();
+		}
+
+		/**
+		 * @return true if there are ready DThreads in the Output Queues of the priority levels above the default one
+		 */
+		inline bool hasPriorityDThreads() const {
+			for (UInt i = 0; i < PRIORITY_LEVELS - 1; ++i)
+				if (!m_priorityQueues[i].isEmpty())
+					return true;
+
+			return false;
 		}
 
 		/**
@@ -130,6 +384,7 @@ class Kernel {
 		 */
 		inline void stop() {
 			m_isFinished = true;
+			m_doorbell.ring();
 
 			// Wait the pthread to finish its execution
 			if (pthread_join(m_pthreadID, NULL) != 0) {
@@ -170,6 +425,38 @@ class Kernel {
 			return m_dataForwardTable;
 		}
 
+		/**
+		 * Executes a ready DThread of the Kernel's queues while the Kernel waits inside the DThread that it currently executes
+		 * (e.g. when the spill memory budget is exhausted)
+		 * @return true if a DThread was executed
+		 * @note only the Kernel's thread calls this function
+		 */
+		inline bool executeReadyDThread() {
+			OQ_Entry entry;
+
+			// The DFT holds the data of the interrupted DThread (distributed mode)
+			if (m_dataForwardTable || m_helpDepth == SPILL_MAX_HELP_DEPTH)
+				return false;
+
+			// The head of a queue is removed after its execution, thus the queue cannot be used if the interrupted DThread is its head
+			if (!m_isExecutingQueueHead)
+				transferOutputQueue();
+
+			if (!m_deque.pop(&entry))
+				return false;
+
+			m_helpDepth++;
+
+			if (entry.isRange)
+				splitLocalRange(&entry);
+
+			executeDThread(&entry, nullptr);
+			m_pendingInDeques->fetch_sub(1);
+			m_helpDepth--;
+
+			return true;
+		}
+
 		/**
 		 * Clears the Data Forward Table of the Kernel
 		 */
@@ -181,9 +468,23 @@ class Kernel {
 	private:
 		KernelID m_kernelID;  // The Kernel's ID
 		OutputQueue m_outputQueue;  // The Kernel's Output Queue that is used to receive the ready DTheads.
+		OutputQueue m_priorityQueues[PRIORITY_LEVELS - 1];  // The Output Queues of the priority levels above the default one. Level L uses the queue L - 1.
+		WorkStealingDeque m_deque;  // Holds the instances that can be executed by this Kernel or stolen by the other Kernels
+		std::atomic<UInt>* m_pendingInDeques;  // Counts the instances of the Work-Stealing Deques of all Kernels that are not executed yet
+		Kernel** m_kernels = nullptr;  // The Kernels of the TSU. It is not null if the work-stealing is enabled.
+		UInt m_kernelsNum = 0;  // The number of the Kernels of the TSU
+		UInt m_randomState;  // The state of the random generator that selects the victims of the work-stealing
+		const IdlePolicy* m_idlePolicy;  // The idle policy of the Kernel
+		Doorbell m_doorbell;  // The TSU rings it when it inserts a ready DThread in the Output Queue of the parked Kernel
+		Doorbell* m_tsuDoorbell = nullptr;  // The Doorbell of the TSU thread that detects the termination
+		Doorbell* m_ownerDoorbell = nullptr;  // The Doorbell of the TSU thread that fills the Kernel's Output Queues
 		volatile bool m_isFinished;  // Indicates if the Kernel will still work
 		pthread_t m_pthreadID;  // The pthread's id that created by pthread_create
 		DataForwardTable* m_dataForwardTable = nullptr;  // Stores the modified data of each DThread
+		bool m_isExecutingQueueHead = false;  // Indicates if the Kernel executes the head of its Output Queue or of a priority queue
+		UInt m_helpDepth = 0;  // The number of the nested DThreads that the Kernel executes while it waits (see executeReadyDThread)
+		UInt m_inlineDepth = 0;  // The number of the nested DThreads that the Kernel executes inline (see executeInline)
+		UInt m_maxInlineDepth = DEFAULT_INLINE_DEPTH;  // The maximum number of the nested DThreads that the Kernel executes inline
 
 		/**
 		 * The Kernel's operation. It executes the ready DThreads.
@@ -191,6 +492,138 @@ class Kernel {
 		 */
 		static void* run(void* arg);
 
+		/**
+		 * Executes the ready DThread with the highest priority, if any
+		 * @param[in] dft the Data Forward Table of the Kernel
+		 * @return true if a DThread was executed
+		 */
+		inline bool executePriorityDThread(DataForwardTable* dft) {
+			for (int level = PRIORITY_LEVELS - 2; level >= 0; --level) {
+				if (!m_priorityQueues[level].isEmpty()) {
+					OQ_Entry entry;
+					m_priorityQueues[level].peekHead(&entry);
+
+					m_isExecutingQueueHead = true;
+					executeDThread(&entry, dft);
+					m_priorityQueues[level].popHead();
+					m_isExecutingQueueHead = false;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/**
+		 * Moves a batch of ready DThreads from the Output Queue into the Work-Stealing Deque, in order to be available to the thieves.
+		 * The transfer stops at the first pinned instance, since the pinned instances are executed only by this Kernel.
+		 * @return the number of the moved DThreads
+		 */
+		inline UInt transferOutputQueue() {
+			OQ_Entry entry;
+			UInt moved = 0;
+
+			while (moved < WSQ_TRANSFER_BATCH && !m_outputQueue.isEmpty() && !m_deque.isFull()) {
+				m_outputQueue.peekHead(&entry);
+
+				if (entry.isPinned)
+					break;
+
+				// Count the instance before it leaves the Output Queue, otherwise the TSU may consider that the Kernels are idle
+				m_pendingInDeques->fetch_add(1);
+				m_outputQueue.popHead();
+				m_deque.push(entry);
+				moved++;
+			}
+
+			if (moved > 0)
+				wakeThief();
+
+			return moved;
+		}
+
+		/**
+		 * Wakes up a parked Kernel, in order to steal the DThreads that became available in the Work-Stealing Deque.
+		 * The parked Kernels check only their own queues before parking, thus without the ring they would steal the DThreads
+		 * only after their park timeout.
+		 */
+		inline void wakeThief() {
+			if (!m_kernels || !m_idlePolicy->parkingEnabled)
+				return;
+
+			// Pairs with the fence of Doorbell::park(), like Doorbell::ring()
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			for (UInt i = 1; i < m_kernelsNum; ++i) {
+				Kernel* thief = m_kernels[(m_kernelID + i) % m_kernelsNum];
+
+				if (thief->m_doorbell.isSleeping()) {
+					thief->m_doorbell.ring();
+					return;
+				}
+			}
+		}
+
+		/**
+		 * Steals a ready DThread from the Work-Stealing Deque of a random victim
+		 * @param[out] item the stolen DThread
+		 * @return true if a DThread is stolen
+		 */
+		inline bool stealDThread(OQ_Entry* const item) {
+			if (m_kernelsNum < 2)
+				return false;
+
+			// Xorshift random generator
+			m_randomState ^= m_randomState << 13;
+			m_randomState ^= m_randomState >> 17;
+			m_randomState ^= m_randomState << 5;
+
+			UInt victim = m_randomState % m_kernelsNum;
+
+			for (UInt i = 0; i < m_kernelsNum; ++i) {
+				if (victim != m_kernelID && m_kernels[victim]->m_deque.steal(item))
+					return true;
+
+				victim = (victim + 1 == m_kernelsNum) ? 0 : victim + 1;
+			}
+
+			return false;
+		}
+
+		/**
+		 * Splits a range of instances until a single instance is left. The upper halves are pushed in the Work-Stealing Deque,
+		 * thus the thieves steal the largest halves and the Kernel continues with the smallest ones.
+		 * @param[in,out] range the range. It keeps the remaining instances, which are more than one only if the deque became full.
+		 */
+		inline void splitLocalRange(OQ_Entry* range) {
+			OQ_Entry upper;
+			bool isSplit = false;
+
+			while (!m_deque.isFull() && splitRange(range, &upper)) {
+				m_pendingInDeques->fetch_add(1);
+				m_deque.push(upper);
+				isSplit = true;
+			}
+
+			if (isSplit)
+				wakeThief();
+		}
+
+		/**
+		 * Executes the DFunction of a ready DThread according to its Nesting Attribute
+		 * @param[in] oqEntry the ready DThread. If it holds a range, all the instances of the range are executed.
+		 * @param[in] dft the Data Forward Table of the Kernel. It is cleared after the execution of each instance (distributed mode).
+		 */
+		static void executeDThread(const OQ_Entry* oqEntry, DataForwardTable* dft);
+
+		/**
+		 * Executes the DFunction of a ready DThread's instance according to its Nesting Attribute
+		 * @param[in] oqEntry the ready DThread
+		 * @param[in] instance the context of the instance
+		 * @param[in] dft the Data Forward Table of the Kernel or null if we are in the single node execution
+		 */
+		static void executeInstance(const OQ_Entry* oqEntry, context_t instance, DataForwardTable* dft);
+
 };
 
 #endif /* KERNEL_H_ */
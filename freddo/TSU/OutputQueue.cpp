@@ -32,8 +32,10 @@
  *	Creates an Output Queue
  */
 OutputQueue::OutputQueue() {
-	m_head = 0;
-	m_tail = 0;
+	m_head.store(0, std::memory_order_relaxed);
+	m_tail.store(0, std::memory_order_relaxed);
+	m_cachedHead = 0;
+	m_cachedTail = 0;
 }
 
 /**
@@ -28,7 +28,9 @@
  *
  *  Notes:
  *  	- The Output Queue is abbreviated as OQ
- *  	- This queue is a wait-free and lock-free implementation which is intended for use by a single consumer-thread and a single producer-thread
+ *  	- This queue is a wait-free and lock-free implementation which is intended for use by a single consumer-thread (a Kernel) and a single producer-thread (the TSU)
+ *  	- The head and the tail are published with release stores and read with acquire loads. They are kept in different cache lines.
+ *  	- Each side caches the index of the other side and re-reads it only when the queue seems to be full (producer) or empty (consumer)
  *  	- In this queue implementation one entry is always unused
  */
 
@@ -37,16 +39,44 @@
 
 // Includes
 #include "../ddm_defs.h"
+#include <atomic>
 
-// Defining the OQ entry
+// Defining the OQ entry. This is the unpacked form of an entry which is used outside of the Output Queue.
 typedef struct {
 		IFP ifp;  // The pointer of the ready DThread's function
 		context_t context;  // The ready DThread's context
-		Nesting nesting;  // The DThread's nesting
-		TID tid;  // The DThread's Identifier
 		void* data = nullptr;  // Currently, this is used for executing Recursive DThreads. This member holds the arguments of the function.
+		context_t maxContext { };  // The end of the Context if the entry holds a range of ready instances
+		Nesting nesting;  // The DThread's nesting
+		bool isRange = false;  // Indicates if the entry holds all the instances from context to maxContext. The Kernels split the ranges lazily.
+		bool isPinned = false;  // Indicates if the Scheduling Policy maps the instance to the Kernel, i.e. it is not moved in the Work-Stealing Deque
 } OQ_Entry;
 
+/* The low bits of the IFP of an OQ slot hold the Nesting of the entry or the OQ_EXTENDED_ENTRY tag if the entry has an extension in the
+ * side lane of the queue. This is possible since the IFP structures are at least 8-byte aligned.
+ */
+#define OQ_TAG_MASK ((uintptr_t) 0x7)
+#define OQ_EXTENDED_ENTRY ((uintptr_t) 0x7)
+
+static_assert(alignof(IFP_t) > OQ_TAG_MASK, "The IFP structures should be at least 8-byte aligned");
+
+/* Defining a slot of the Output Queue. It holds a single ready instance without data, i.e. the most common entries
+ * (16 bytes with the 64-bit Contexts). The ranges, the instances with data and the pinned instances are extended in the side lane.
+ */
+typedef struct {
+		uintptr_t taggedIFP;  // The pointer of the ready DThread's function and the tag of the entry
+		context_t context;  // The ready DThread's context
+} OQ_Slot;
+
+// Defining the extension of an OQ slot. It is stored in the side lane of the queue, at the same index as the slot.
+typedef struct {
+		void* data;  // The arguments of the DThread's function
+		context_t maxContext;  // The end of the Context if the entry holds a range of ready instances
+		Nesting nesting;  // The DThread's nesting
+		bool isRange;  // Indicates if the entry holds all the instances from context to maxContext
+		bool isPinned;  // Indicates if the instance is not moved in the Work-Stealing Deque
+} OQ_SlotExtension;
+
 /* Increment an index by one. The modulo operation is used to make circle in the circular buffer.
  * We use the bitwise_and operation instead of modulo to increase the performance. Notice that the IQ_SIZE has to be in the power of 2.
  * The formula is as follows: X % NUMBER == X & (NUMBER-1)
@@ -70,82 +100,85 @@ class OutputQueue {
 		 @return true if the Output Queue is empty
 		 */
 		inline bool isEmpty(void) const {
-			return (m_head == m_tail);
+			return (m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire));
 		}
 
 		/**
 		 @return true if the Output Queue is full
 		 */
 		inline bool isFull(void) const {
-			const UInt next_tail = INCR_OQ_INDX(m_tail);
+			const UInt next_tail = INCR_OQ_INDX(m_tail.load(std::memory_order_acquire));
 
-			return (next_tail == m_head);
+			return (next_tail == m_head.load(std::memory_order_acquire));
 		}
 
 		/**
 		 Returns the Output Queue's head but does not remove the element
-		 @return a pointer to the head of the queue
+		 @param[out] item the OQ entry that will be filled with the head's value
 		 */
-		inline const OQ_Entry* peekHead(void) const {
-			return (m_entries + m_head);
+		inline void peekHead(OQ_Entry* const item) const {
+			unpackSlot(m_head.load(std::memory_order_relaxed), item);
 		}
 
 		/**
 		 @return the number of entries in the Output Queue
 		 */
 		inline int getSize() const {
-			if (m_head <= m_tail)
-				return m_tail - m_head;
+			const UInt head = m_head.load(std::memory_order_acquire);
+			const UInt tail = m_tail.load(std::memory_order_acquire);
+
+			if (head <= tail)
+				return tail - head;
 			else
-				return (OQ_SIZE - m_head) + m_tail;
+				return (OQ_SIZE - head) + tail;
 		}
 
 		/**
 		 Enqueue an OQ entry.
 		 @param[in] ifp the pointer of the ready DThread's function
-		 @param[in] tid the DThread's identifier
 		 @param[in] context the ready DThread's context
 		 @param[in] nesting the ready DThread's nesting
+		 @param[in] data the pointer to the arguments of the DThread
 		 @return true if the enqueue was completed or false if the queue was full
 		 @note Push on tail. The tail is only changed by producer (the Kernel)
 		 */
-		inline bool enqueue(IFP ifp, TID tid, context_t context, Nesting nesting) {
-			UInt curHead = m_head;  // Storing head in order to avoid queue full state if we remove the item from the queue immediately after we put it
-			UInt next_tail = INCR_OQ_INDX(m_tail);
-
-			if (next_tail != curHead) {
-				m_entries[m_tail].ifp = ifp;
-				m_entries[m_tail].tid = tid;
-				m_entries[m_tail].context = context;
-				m_entries[m_tail].nesting = nesting;
-				m_tail = next_tail;
-				return true;
-			}
+		inline bool enqueue(IFP ifp, context_t context, Nesting nesting, void* data = nullptr) {
+			OQ_Entry entry;
+			entry.ifp = ifp;
+			entry.context = context;
+			entry.nesting = nesting;
+			entry.data = data;
 
-			return false;  // The queue is full
+			return enqueue(entry);
 		}
 
 		/**
-		 Enqueue an OQ entry.
-		 @param[in] ifp the pointer of the ready DThread's function
-		 @param[in] tid the DThread's identifier
-		 @param[in] context the ready DThread's context
-		 @param[in] nesting the ready DThread's nesting
-		 @param[in] data the pointer to the arguments of the DThread
+		 Enqueue a copy of an OQ entry, e.g. an entry that holds a range of ready instances of the same DThread.
+		 @param[in] entry the OQ entry
 		 @return true if the enqueue was completed or false if the queue was full
 		 @note Push on tail. The tail is only changed by producer (the Kernel)
 		 */
-		inline bool enqueue(IFP ifp, TID tid, context_t context, Nesting nesting, void* data) {
-			UInt curHead = m_head;  // Storing head in order to avoid queue full state if we remove the item from the queue immediately after we put it
-			UInt next_tail = INCR_OQ_INDX(m_tail);
-
-			if (next_tail != curHead) {
-				m_entries[m_tail].ifp = ifp;
-				m_entries[m_tail].tid = tid;
-				m_entries[m_tail].context = context;
-				m_entries[m_tail].nesting = nesting;
-				m_entries[m_tail].data = data;
-				m_tail = next_tail;
+		inline bool enqueue(const OQ_Entry& entry) {
+			const UInt tail = m_tail.load(std::memory_order_relaxed);
+			const UInt next_tail = INCR_OQ_INDX(tail);
+
+			if (next_tail != m_cachedHead || next_tail != (m_cachedHead = m_head.load(std::memory_order_acquire))) {
+				OQ_Slot& slot = m_slots[tail];
+				slot.context = entry.context;
+
+				if (entry.isRange || entry.isPinned || entry.data != nullptr) {
+					m_extensions[tail].data = entry.data;
+					m_extensions[tail].maxContext = entry.maxContext;
+					m_extensions[tail].nesting = entry.nesting;
+					m_extensions[tail].isRange = entry.isRange;
+					m_extensions[tail].isPinned = entry.isPinned;
+					slot.taggedIFP = (uintptr_t) entry.ifp | OQ_EXTENDED_ENTRY;
+				}
+				else {
+					slot.taggedIFP = (uintptr_t) entry.ifp | (uintptr_t) entry.nesting;
+				}
+
+				m_tail.store(next_tail, std::memory_order_release);
 				return true;
 			}
 
@@ -159,11 +192,13 @@ class OutputQueue {
 		 * @note Only the consumer (the TSU) can change the head
 		 */
 		inline bool dequeue(OQ_Entry* const item) {
-			if (m_head == m_tail)
+			const UInt head = m_head.load(std::memory_order_relaxed);
+
+			if (head == m_cachedTail && head == (m_cachedTail = m_tail.load(std::memory_order_acquire)))
 				return false;  // The queue is empty
 
-			*item = m_entries[m_head];
-			m_head = INCR_OQ_INDX(m_head);
+			unpackSlot(head, item);
+			m_head.store(INCR_OQ_INDX(head), std::memory_order_release);
 
 			return true;
 		}
@@ -174,18 +209,57 @@ class OutputQueue {
 		 * @note Only the consumer can change the head
 		 */
 		inline bool popHead(void) {
-			if (m_head == m_tail)
+			const UInt head = m_head.load(std::memory_order_relaxed);
+
+			if (head == m_cachedTail && head == (m_cachedTail = m_tail.load(std::memory_order_acquire)))
 				return false;  // The queue is empty
 
-			m_head = INCR_OQ_INDX(m_head);
+			m_head.store(INCR_OQ_INDX(head), std::memory_order_release);
 
 			return true;
 		}
 
 	private:
-		OQ_Entry m_entries[OQ_SIZE];  // The entries of the queue
-		volatile UInt m_head;  // Points to the head (front) of the queue
-		volatile UInt m_tail;  // Points to the tail (rear) of the queue
+		// The consumer's cache line
+		std::atomic<UInt> m_head;  // Points to the head (front) of the queue. It is only changed by the consumer.
+		UInt m_cachedTail;  // The consumer's copy of the tail
+		char m_padHead[CACHE_LINE_SIZE - sizeof(std::atomic<UInt>) - sizeof(UInt)];  // Keeps the head and the tail in different cache lines
+
+		// The producer's cache line
+		std::atomic<UInt> m_tail;  // Points to the tail (rear) of the queue. It is only changed by the producer.
+		UInt m_cachedHead;  // The producer's copy of the head
+		char m_padTail[CACHE_LINE_SIZE - sizeof(std::atomic<UInt>) - sizeof(UInt)];  // Keeps the tail and the entries in different cache lines
+
+		OQ_Slot m_slots[OQ_SIZE];  // The entries of the queue
+		OQ_SlotExtension m_extensions[OQ_SIZE];  // The side lane. It is only accessed for the slots with the OQ_EXTENDED_ENTRY tag.
+
+		/**
+		 Unpacks a slot of the queue
+		 @param[in] index the index of the slot
+		 @param[out] item the OQ entry that will be filled with the slot's value
+		 */
+		inline void unpackSlot(UInt index, OQ_Entry* const item) const {
+			const OQ_Slot& slot = m_slots[index];
+			const uintptr_t tag = slot.taggedIFP & OQ_TAG_MASK;
+
+			item->ifp = (IFP) (slot.taggedIFP & ~OQ_TAG_MASK);
+			item->context = slot.context;
+
+			if (tag == OQ_EXTENDED_ENTRY) {
+				const OQ_SlotExtension& extension = m_extensions[index];
+				item->data = extension.data;
+				item->maxContext = extension.maxContext;
+				item->nesting = extension.nesting;
+				item->isRange = extension.isRange;
+				item->isPinned = extension.isPinned;
+			}
+			else {
+				item->data = nullptr;
+				item->nesting = (Nesting) tag;
+				item->isRange = false;
+				item->isPinned = false;
+			}
+		}
 };
 
 #endif /* OUTPUTQUEUE_H_ */
@@ -42,6 +42,12 @@ typedef struct {
 		UInt middleRange;
 		UInt outerRange;
 		bool isStatic;						// Indicates if the StaticSM will be used
+		SMType smType = SMType::AUTO_SM;	// The storage of the SM
+		SchedulingMethod schedMethod = SchedulingMethod::DYNAMIC;	// The Scheduling Method
+		UInt schedValue = 0;			// The Scheduling Value
+		SchedulingFunction schedFunction = nullptr;	// The function of the CUSTOM Scheduling Method
+		UInt priority = DEFAULT_PRIORITY;	// The priority of the ready instances
+		PriorityFunction priorityFunction = nullptr;	// Returns the priority of each ready instance
 } PendingThreadTemplate;
 
 using PendingDThreads = std::unordered_map<TID, PendingThreadTemplate>;
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * PendingWorkMap.cpp
+ */
+
+#include "PendingWorkMap.h"
+
+/**
+ * Creates a Pending Work Map
+ * @param[in] size the number of the indexes (Kernels) of the map
+ */
+PendingWorkMap::PendingWorkMap(UInt size) {
+	m_numOfWords = (size + 63) / 64;
+
+	if (m_numOfWords == 0)
+		m_numOfWords = 1;
+
+	m_words = new std::atomic<uint64_t>[m_numOfWords];
+
+	for (UInt i = 0; i < m_numOfWords; ++i)
+		m_words[i].store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Releases the memory allocated by the Pending Work Map
+ */
+PendingWorkMap::~PendingWorkMap() {
+	delete[] m_words;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * PendingWorkMap.h
+ *
+ *  Description: A bitmap with one bit per Kernel. The bit of a Kernel is set when the Kernel sends updates to the TSU and it is cleared
+ *  by the TSU when it drains the Kernel's Input Queue and Unlimited Input Queue. As such, the TSU finds the non-empty queues without
+ *  reading the queues of the idle Kernels.
+ *
+ *  Notes:
+ *  	- A producer sets its bit only if it finds it cleared, thus a Kernel that sends many updates writes the shared word
+ *  	  once per drain of its queues
+ *  	- The bits are hints. A producer that finds its bit set while the TSU clears it may leave a non-empty queue unmarked
+ *  	  for a while. The TSU recovers such queues by checking one queue per unsuccessful search (see the TSU's rrScheduler).
+ */
+
+#ifndef PENDINGWORKMAP_H_
+#define PENDINGWORKMAP_H_
+
+// Includes
+#include "../ddm_defs.h"
+#include <atomic>
+#include <stdint.h>
+
+// The value returned by PendingWorkMap::findNext if there is no marked index
+#define NO_PENDING_WORK ((UInt) -1)
+
+class PendingWorkMap {
+	public:
+
+		/**
+		 * Creates a Pending Work Map
+		 * @param[in] size the number of the indexes (Kernels) of the map
+		 */
+		PendingWorkMap(UInt size);
+
+		/**
+		 * Releases the memory allocated by the Pending Work Map
+		 */
+		~PendingWorkMap();
+
+		/**
+		 * Marks that an index has pending work
+		 * @param[in] index the index
+		 */
+		inline void mark(UInt index) {
+			std::atomic<uint64_t>& word = m_words[index >> 6];
+			const uint64_t mask = (uint64_t) 1 << (index & 63);
+
+			if (!(word.load(std::memory_order_relaxed) & mask))
+				word.fetch_or(mask, std::memory_order_release);
+		}
+
+		/**
+		 * Clears the mark of an index
+		 * @param[in] index the index
+		 * @note the caller has to check the work of the index after this call, since a producer may have missed the clearing
+		 */
+		inline void clear(UInt index) {
+			m_words[index >> 6].fetch_and(~((uint64_t) 1 << (index & 63)), std::memory_order_seq_cst);
+		}
+
+		/**
+		 * @return true if there is no marked index
+		 */
+		inline bool isEmpty() const {
+			for (UInt i = 0; i < m_numOfWords; ++i)
+				if (m_words[i].load(std::memory_order_acquire) != 0)
+					return false;
+
+			return true;
+		}
+
+		/**
+		 * Finds the first marked index, starting from an index and wrapping around at the end of the map
+		 * @param[in] start the index from which the search starts
+		 * @return the marked index or NO_PENDING_WORK if there is no marked index
+		 */
+		inline UInt findNext(UInt start) const {
+			UInt w = start >> 6;
+			uint64_t bits = m_words[w].load(std::memory_order_acquire) & (~(uint64_t) 0 << (start & 63));
+
+			// Check the words after the start and then the words before it (including the start's word)
+			for (UInt i = 0; i <= m_numOfWords; ++i) {
+				if (bits)
+					return (w << 6) + __builtin_ctzll(bits);
+
+				w = (w + 1 == m_numOfWords) ? 0 : w + 1;
+				bits = m_words[w].load(std::memory_order_acquire);
+			}
+
+			return NO_PENDING_WORK;
+		}
+
+	private:
+		std::atomic<uint64_t>* m_words;  // The words of the bitmap. Index i is mapped to the bit (i % 64) of the word (i / 64).
+		UInt m_numOfWords;  // The number of the words
+};
+
+#endif /* PENDINGWORKMAP_H_ */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * ReadyBacklog.cpp
+ */
+
+#include "ReadyBacklog.h"
+#include <new>
+
+/**
+ * Creates a Ready Backlog
+ * @param[in] budget the memory budget that the segments are charged to or nullptr if the backlog is not charged
+ */
+ReadyBacklog::ReadyBacklog(SpillBudget* budget) {
+	m_budget = budget;
+	m_spareSegment = nullptr;
+	m_head = m_tail = 0;
+
+	// The first segment is not charged to the budget, like the first segment of an Unlimited Input Queue
+	m_headSegment = m_tailSegment = new (std::nothrow) ReadyBacklogSegment;
+
+	if (!m_headSegment) {
+		printf("Error in ReadyBacklog constructor => Memory allocation failed\n");
+		exit(ERROR);
+	}
+
+	m_headSegment->next = nullptr;
+	m_segments = 1;
+}
+
+/**
+ * Releases the memory allocated by the Ready Backlog
+ */
+ReadyBacklog::~ReadyBacklog() {
+	ReadyBacklogSegment* segment = m_headSegment;
+
+	while (segment) {
+		ReadyBacklogSegment* next = segment->next;
+		delete segment;
+		segment = next;
+	}
+
+	delete m_spareSegment;
+
+	if (m_budget && m_segments > 1)
+		m_budget->release((m_segments - 1) * sizeof(ReadyBacklogSegment));
+}
+
+/**
+ * @return the spare segment or a new segment if there is no spare one
+ */
+ReadyBacklogSegment* ReadyBacklog::getSegment() {
+	ReadyBacklogSegment* segment = m_spareSegment;
+
+	if (segment) {
+		m_spareSegment = nullptr;
+	}
+	else {
+		segment = new (std::nothrow) ReadyBacklogSegment;
+
+		if (!segment) {
+			printf("Error while inserting a ready DThread in the Ready Backlog => Memory allocation failed\n");
+			exit(ERROR);
+		}
+
+		m_segments++;
+
+		// The TSU cannot wait for the Kernels, thus the soft limit is ignored
+		if (m_budget)
+			m_budget->charge(sizeof(ReadyBacklogSegment), true);
+	}
+
+	segment->next = nullptr;
+	return segment;
+}
+
+/**
+ * Keeps a drained segment as the spare segment or releases it if there is already a spare one
+ * @param[in] segment the drained segment
+ */
+void ReadyBacklog::recycleSegment(ReadyBacklogSegment* segment) {
+	if (!m_spareSegment) {
+		m_spareSegment = segment;
+		return;
+	}
+
+	delete segment;
+	m_segments--;
+
+	if (m_budget)
+		m_budget->release(sizeof(ReadyBacklogSegment));
+}
+
+/**
+ * Releases the spare segment, in order to not hold the memory budget while the backlog is empty
+ */
+void ReadyBacklog::releaseSpareSegment() {
+	delete m_spareSegment;
+	m_spareSegment = nullptr;
+	m_segments--;
+
+	if (m_budget)
+		m_budget->release(sizeof(ReadyBacklogSegment));
+}
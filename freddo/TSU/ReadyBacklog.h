@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * ReadyBacklog.h
+ *
+ *  Description: Holds the ready instances that did not fit in the Output Queues of a Kernel, since the TSU cannot wait for the Kernel.
+ *  The backlog is a chain of fixed-size segments, like the Unlimited Input Queue.
+ *
+ *  Notes:
+ *  	- It is used only by the TSU thread that owns the Kernel, thus it is not thread-safe
+ *  	- The segments beyond the first one are charged to the spill memory budget. The TSU never waits for the budget, but the Kernels
+ *  	  are throttled while the Ready Backlogs hold the budget, i.e. they execute ready DThreads instead of spilling more updates.
+ *  	- A drained segment is kept as a spare segment until the backlog is empty, thus a draining backlog that keeps growing does not allocate
+ */
+
+#ifndef READYBACKLOG_H_
+#define READYBACKLOG_H_
+
+// Includes
+#include "../ddm_defs.h"
+#include "OutputQueue.h"
+#include "UnlimitedInputQueue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "../Error.h"
+
+// A ready instance that is waiting in a Ready Backlog until its Kernel's Output Queue has free space
+typedef struct {
+		OQ_Entry entry;  // The ready instance (or range of instances)
+		UInt priority;  // The priority of the instance
+} BacklogEntry;
+
+// Defining a segment of the Ready Backlog
+struct ReadyBacklogSegment {
+		BacklogEntry entries[READY_BACKLOG_SEGMENT_SIZE];  // The entries of the segment
+		ReadyBacklogSegment* next;  // The next segment of the chain
+};
+
+class ReadyBacklog {
+	public:
+
+		/**
+		 * Creates a Ready Backlog
+		 * @param[in] budget the memory budget that the segments are charged to or nullptr if the backlog is not charged
+		 */
+		ReadyBacklog(SpillBudget* budget = nullptr);
+
+		/**
+		 * Releases the memory allocated by the Ready Backlog
+		 */
+		~ReadyBacklog();
+
+		/**
+		 * @return true if the Ready Backlog is empty
+		 */
+		inline bool empty() const {
+			return m_head == m_tail && m_headSegment == m_tailSegment;
+		}
+
+		/**
+		 * @return the oldest entry of the Ready Backlog
+		 * @note call this function only if the backlog is not empty
+		 */
+		inline const BacklogEntry& front() const {
+			return m_headSegment->entries[m_head];
+		}
+
+		/**
+		 * Appends an entry to the Ready Backlog. A new segment is charged to the memory budget even if the budget is exhausted.
+		 * @param[in] entry the entry
+		 */
+		inline void push(const BacklogEntry& entry) {
+			if (m_tail == READY_BACKLOG_SEGMENT_SIZE) {
+				ReadyBacklogSegment* segment = getSegment();
+				m_tailSegment->next = segment;
+				m_tailSegment = segment;
+				m_tail = 0;
+			}
+
+			m_tailSegment->entries[m_tail++] = entry;
+		}
+
+		/**
+		 * Removes the oldest entry of the Ready Backlog
+		 * @note call this function only if the backlog is not empty
+		 */
+		inline void pop() {
+			m_head++;
+
+			if (m_headSegment == m_tailSegment) {
+				// The backlog is empty. Reuse its last segment from the start and return the spare segment to the budget.
+				if (m_head == m_tail) {
+					m_head = m_tail = 0;
+
+					if (m_spareSegment)
+						releaseSpareSegment();
+				}
+			}
+			else if (m_head == READY_BACKLOG_SEGMENT_SIZE) {
+				ReadyBacklogSegment* drained = m_headSegment;
+				m_headSegment = drained->next;
+				m_head = 0;
+				recycleSegment(drained);
+			}
+		}
+
+	private:
+		ReadyBacklogSegment* m_headSegment;  // The segment that holds the head (front) of the backlog
+		ReadyBacklogSegment* m_tailSegment;  // The segment that holds the tail (rear) of the backlog
+		ReadyBacklogSegment* m_spareSegment;  // A drained segment that is reused by the next push to a full segment
+		UInt m_head;  // The index of the head in m_headSegment
+		UInt m_tail;  // The index of the tail in m_tailSegment
+		UInt m_segments;  // The number of the allocated segments, including the spare one
+		SpillBudget* m_budget;  // The memory budget that the segments beyond the first one are charged to or nullptr
+
+		/**
+		 * @return the spare segment or a new segment if there is no spare one
+		 */
+		ReadyBacklogSegment* getSegment();
+
+		/**
+		 * Keeps a drained segment as the spare segment or releases it if there is already a spare one
+		 * @param[in] segment the drained segment
+		 */
+		void recycleSegment(ReadyBacklogSegment* segment);
+
+		/**
+		 * Releases the spare segment, in order to not hold the memory budget while the backlog is empty
+		 */
+		void releaseSpareSegment();
+};
+
+#endif /* READYBACKLOG_H_ */
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * ContextDomain.cpp
+ */
+
+#include "ContextDomain.h"
+
+/**
+ * Creates a domain without constraints, i.e. all the contexts of the ranges are valid
+ */
+ContextDomain::ContextDomain() {
+	m_numOfConstraints = 0;
+
+	for (UInt i = 0; i < CONTEXT_DOMAIN_MAX_CONSTRAINTS; ++i)
+		m_outerCoef[i] = m_middleCoef[i] = m_innerCoef[i] = m_constant[i] = 0;
+}
+
+/**
+ * Adds the constraint: outerCoef * Outer + middleCoef * Middle + innerCoef * Inner + constant >= 0
+ * @param[in] outerCoef the coefficient of the Outer part
+ * @param[in] middleCoef the coefficient of the Middle part
+ * @param[in] innerCoef the coefficient of the Inner part
+ * @param[in] constant the constant term
+ * @return the domain
+ */
+ContextDomain& ContextDomain::addConstraint(int outerCoef, int middleCoef, int innerCoef, int constant) {
+	if (m_numOfConstraints == CONTEXT_DOMAIN_MAX_CONSTRAINTS) {
+		printf("Error in ContextDomain => The maximum number of constraints (%d) is reached\n", CONTEXT_DOMAIN_MAX_CONSTRAINTS);
+		exit(ERROR);
+	}
+
+	m_outerCoef[m_numOfConstraints] = outerCoef;
+	m_middleCoef[m_numOfConstraints] = middleCoef;
+	m_innerCoef[m_numOfConstraints] = innerCoef;
+	m_constant[m_numOfConstraints] = constant;
+	m_numOfConstraints++;
+
+	return *this;
+}
+
+/**
+ * Adds the constraint: first >= second + offset
+ * @param[in] first the first part of the Context
+ * @param[in] second the second part of the Context
+ * @param[in] offset the offset of the second part
+ * @return the domain
+ */
+ContextDomain& ContextDomain::greaterEqual(ContextPart first, ContextPart second, int offset) {
+	int coef[3] = { 0, 0, 0 };  // Indexed by ContextPart
+
+	coef[first] += 1;
+	coef[second] -= 1;
+
+	return addConstraint(coef[OUTER_CONTEXT], coef[MIDDLE_CONTEXT], coef[INNER_CONTEXT], -offset);
+}
+
+/**
+ * Finds the Inner parts of the domain for specific Outer and Middle parts
+ * @param[in] outer the Outer part of the Context
+ * @param[in] middle the Middle part of the Context
+ * @param[in] innerRange the range of the Inner part
+ * @param[out] first the first valid Inner part
+ * @param[out] count the number of the valid Inner parts. It is zero if there are not any.
+ */
+void ContextDomain::getInnerInterval(int64_t outer, int64_t middle, size_t innerRange, size_t& first, size_t& count) const {
+	int64_t low = 0, high = (int64_t) innerRange - 1;
+
+	for (UInt i = 0; i < m_numOfConstraints; ++i) {
+		int64_t rest = m_outerCoef[i] * outer + m_middleCoef[i] * middle + m_constant[i];
+		int64_t coef = m_innerCoef[i];
+
+		if (coef == 0) {
+			if (rest < 0)  // The constraint does not depend on the Inner part and it is not satisfied
+				high = low - 1;
+		}
+		else if (coef > 0) {
+			// Inner >= ceil(-rest / coef)
+			int64_t bound = (-rest >= 0) ? (-rest + coef - 1) / coef : -(rest / coef);
+
+			if (bound > low)
+				low = bound;
+		}
+		else {
+			// Inner <= floor(rest / -coef)
+			int64_t bound = (rest >= 0) ? rest / -coef : -((-rest - coef - 1) / -coef);
+
+			if (bound < high)
+				high = bound;
+		}
+	}
+
+	first = (low <= high) ? low : 0;
+	count = (low <= high) ? high - low + 1 : 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * ContextDomain.h
+ *
+ * Description: The domain of the Contexts of a DThread, i.e. the contexts of the ranges that satisfy a set of affine constraints
+ * of the form: outerCoef * Outer + middleCoef * Middle + innerCoef * Inner + constant >= 0.
+ * It is used by the Static SM in order to store only the Ready Counts of the domain, e.g. the triangular or tetrahedral
+ * iteration spaces of the factorizations (LU, Cholesky, QR).
+ *
+ * Example (the Contexts of LU's comb DThread, i.e. Middle > Outer and Inner > Outer):
+ * 		ContextDomain().greaterThan(MIDDLE_CONTEXT, OUTER_CONTEXT).greaterThan(INNER_CONTEXT, OUTER_CONTEXT)
+ *
+ * Notes:
+ * 		- The Middle part is zero for the Nesting-2 DThreads and the Outer and Middle parts are zero for the Nesting-1 DThreads
+ * 		- The domain is convex, i.e. for each Outer and Middle the valid Inner parts are consecutive
+ */
+
+#ifndef CONTEXTDOMAIN_H_
+#define CONTEXTDOMAIN_H_
+
+// Includes
+#include "../../ddm_defs.h"
+#include "../../Error.h"
+#include <stdio.h>
+#include <stdint.h>
+
+class ContextDomain {
+	public:
+
+		/**
+		 * Creates a domain without constraints, i.e. all the contexts of the ranges are valid
+		 */
+		ContextDomain();
+
+		/**
+		 * Adds the constraint: outerCoef * Outer + middleCoef * Middle + innerCoef * Inner + constant >= 0
+		 * @param[in] outerCoef the coefficient of the Outer part
+		 * @param[in] middleCoef the coefficient of the Middle part
+		 * @param[in] innerCoef the coefficient of the Inner part
+		 * @param[in] constant the constant term
+		 * @return the domain
+		 */
+		ContextDomain& addConstraint(int outerCoef, int middleCoef, int innerCoef, int constant);
+
+		/**
+		 * Adds the constraint: first > second + offset
+		 * @param[in] first the first part of the Context
+		 * @param[in] second the second part of the Context
+		 * @param[in] offset the offset of the second part
+		 * @return the domain
+		 */
+		inline ContextDomain& greaterThan(ContextPart first, ContextPart second, int offset = 0) {
+			return greaterEqual(first, second, offset + 1);
+		}
+
+		/**
+		 * Adds the constraint: first >= second + offset
+		 * @param[in] first the first part of the Context
+		 * @param[in] second the second part of the Context
+		 * @param[in] offset the offset of the second part
+		 * @return the domain
+		 */
+		ContextDomain& greaterEqual(ContextPart first, ContextPart second, int offset = 0);
+
+		/**
+		 * Checks if a Context satisfies the constraints of the domain. All the constraints are evaluated without branches,
+		 * such as, the loop is vectorized.
+		 * @param[in] outer the Outer part of the Context
+		 * @param[in] middle the Middle part of the Context
+		 * @param[in] inner the Inner part of the Context
+		 * @return true if the Context belongs to the domain
+		 */
+		inline bool contains(int64_t outer, int64_t middle, int64_t inner) const {
+			int valid = 1;
+
+			// The unused constraints are zero, i.e. always satisfied
+			for (UInt i = 0; i < CONTEXT_DOMAIN_MAX_CONSTRAINTS; ++i)
+				valid &= (m_outerCoef[i] * outer + m_middleCoef[i] * middle + m_innerCoef[i] * inner + m_constant[i] >= 0);
+
+			return valid;
+		}
+
+		/**
+		 * Finds the Inner parts of the domain for specific Outer and Middle parts
+		 * @param[in] outer the Outer part of the Context
+		 * @param[in] middle the Middle part of the Context
+		 * @param[in] innerRange the range of the Inner part
+		 * @param[out] first the first valid Inner part
+		 * @param[out] count the number of the valid Inner parts. It is zero if there are not any.
+		 */
+		void getInnerInterval(int64_t outer, int64_t middle, size_t innerRange, size_t& first, size_t& count) const;
+
+	private:
+		// The coefficients of the constraints
+		int64_t m_outerCoef[CONTEXT_DOMAIN_MAX_CONSTRAINTS];
+		int64_t m_middleCoef[CONTEXT_DOMAIN_MAX_CONSTRAINTS];
+		int64_t m_innerCoef[CONTEXT_DOMAIN_MAX_CONSTRAINTS];
+		int64_t m_constant[CONTEXT_DOMAIN_MAX_CONSTRAINTS];
+		UInt m_numOfConstraints;  // The number of the constraints that are used
+};
+
+#endif /* CONTEXTDOMAIN_H_ */
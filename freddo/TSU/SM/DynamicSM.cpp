@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * DynamicSM.cpp
+ */
+
+#include "DynamicSM.h"
+
+/**
+ * Creates the Dynamic SM
+ * @param readyCount the ready count of the DThread
+ * @param type the storage of the SM (HASH_SM, BTREE_SM, SPARSE_SM or AUTO_SM)
+ * @param initialCapacity the initial number of slots of the HASH_SM storage. It is ignored by the other storages.
+ */
+DynamicSM::DynamicSM(ReadyCount readyCount, SMType type, size_t initialCapacity) {
+	m_type = (type == SMType::AUTO_SM) ? DEFAULT_DYNAMIC_SM : type;
+
+	switch (m_type) {
+		case SMType::HASH_SM:
+			m_hashSM = new DynamicSM_FLATMAP(readyCount, initialCapacity);
+			break;
+
+		case SMType::BTREE_SM:
+			m_btreeSM = new DynamicSM_BTREEMAP(readyCount);
+			break;
+
+		case SMType::SPARSE_SM:
+			m_sparseSM = new DynamicSM_UMAP(readyCount);
+			break;
+
+		default:
+			printf("Error in DynamicSM constructor => The storage %d is not a dynamic storage\n", (int) type);
+			exit(ERROR);
+	}
+
+	if (pthread_mutex_init(&m_mutex, NULL) != 0) {
+		printf("Error in DynamicSM constructor => Mutex m_mutex failed to be initialized\n");
+		exit(ERROR);
+	}
+}
+
+/**
+ * Deallocates the Dynamic SM's resources
+ */
+DynamicSM::~DynamicSM() {
+	switch (m_type) {
+		case SMType::HASH_SM:
+			delete m_hashSM;
+			break;
+
+		case SMType::BTREE_SM:
+			delete m_btreeSM;
+			break;
+
+		default:
+			delete m_sparseSM;
+			break;
+	}
+
+	pthread_mutex_destroy(&m_mutex);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * DynamicSM.h
+ *
+ * Description: The Dynamic SM of a DThread, i.e. the Synchronization Memory that is used when the ranges of the Contexts
+ * are not known or a DThread selects a dynamic storage (see SMType). Each DThread selects its own storage:
+ * 		- HASH_SM: open-addressing hash table (DynamicSM_FLATMAP)
+ * 		- BTREE_SM: google's BTREE map (DynamicSM_BTREEMAP)
+ * 		- SPARSE_SM: unordered map (DynamicSM_UMAP)
+ * 		- AUTO_SM: the storage selected by USE_DYNAMIC_SM_* (ddm_defs.h)
+ *
+ * The storage is selected with a switch on every update instead of a virtual call, in order to allow the inlining of
+ * the hash-based storages in the TSU's loop.
+ */
+
+#ifndef DYNAMICSM_H_
+#define DYNAMICSM_H_
+
+// Includes
+#include "../../ddm_defs.h"
+#include "DynamicSM_FLATMAP.h"
+#include "DynamicSM_BTREEMAP.h"
+#include "DynamicSM_UMAP.h"
+#include <pthread.h>
+
+// The storage of the DThreads that do not select one
+#if defined (USE_DYNAMIC_SM_FLAT_MAP)
+#define DEFAULT_DYNAMIC_SM SMType::HASH_SM
+#elif defined (USE_DYNAMIC_SM_BTREE_MAP)
+#define DEFAULT_DYNAMIC_SM SMType::BTREE_SM
+#else
+#define DEFAULT_DYNAMIC_SM SMType::SPARSE_SM
+#endif
+
+class DynamicSM {
+	public:
+
+		/**
+		 * Creates the Dynamic SM
+		 * @param readyCount the ready count of the DThread
+		 * @param type the storage of the SM (HASH_SM, BTREE_SM, SPARSE_SM or AUTO_SM)
+		 * @param initialCapacity the initial number of slots of the HASH_SM storage. It is ignored by the other storages.
+		 */
+		DynamicSM(ReadyCount readyCount, SMType type = SMType::AUTO_SM, size_t initialCapacity = DYNAMIC_SM_INITIAL_CAPACITY);
+
+		/**
+		 * Deallocates the Dynamic SM's resources
+		 */
+		~DynamicSM();
+
+		/**
+		 * Updates an instance of the DThread
+		 * @param context the Context attribute
+		 * @return true if the DThread's instance is ready for execution
+		 */
+		inline bool update(context_t context) {
+			switch (m_type) {
+				case SMType::HASH_SM:
+					return m_hashSM->update(context);
+
+				case SMType::BTREE_SM:
+					return m_btreeSM->update(context);
+
+				default:
+					return m_sparseSM->update(context);
+			}
+		}
+
+		/**
+		 * Updates an instance of the DThread. This function is thread-safe and it is used when the
+		 * Kernels apply their updates concurrently (decentralized updates).
+		 * @param context the Context attribute
+		 * @return true if the DThread's instance is ready for execution
+		 */
+		inline bool concurrentUpdate(context_t context) {
+			pthread_mutex_lock(&m_mutex);
+			bool isReady = update(context);
+			pthread_mutex_unlock(&m_mutex);
+
+			return isReady;
+		}
+
+		/**
+		 * Restores the initial Ready Counts of all the instances
+		 */
+		inline void reset() {
+			switch (m_type) {
+				case SMType::HASH_SM:
+					m_hashSM->reset();
+					break;
+
+				case SMType::BTREE_SM:
+					m_btreeSM->reset();
+					break;
+
+				default:
+					m_sparseSM->reset();
+					break;
+			}
+		}
+
+		/**
+		 * @return the storage of the SM
+		 */
+		inline SMType getType() const {
+			return m_type;
+		}
+
+	private:
+		SMType m_type;  // The storage of the SM
+
+		// The storage that is used. Only the pointer of m_type is valid.
+		union {
+				DynamicSM_FLATMAP* m_hashSM;
+				DynamicSM_BTREEMAP* m_btreeSM;
+				DynamicSM_UMAP* m_sparseSM;
+		};
+
+		pthread_mutex_t m_mutex;  // Protects the SM when the updates are applied concurrently
+};
+
+#endif /* DYNAMICSM_H_ */
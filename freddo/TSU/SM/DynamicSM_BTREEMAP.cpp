@@ -19,7 +19,7 @@
  */
 
 /*
- * DynamicSM_UMAP.cpp
+ * DynamicSM_BTREEMAP.cpp
  *
  *  Created on: Apr 17, 2015
  *      Author: geomat
@@ -27,29 +27,88 @@
 
 #include "DynamicSM_BTREEMAP.h"
 
-#if defined (USE_DYNAMIC_SM_BTREE_MAP)
+// The vendored btree triggers false positives of the newer compilers' bounds checks and it type-puns its node fields
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#pragma GCC diagnostic ignored "-Wstrict-aliasing"
 
-/**
- * Creates the Dynamic SM using an Unordered MAP
- * @param readyCount the ready count of the DThread
- */
-DynamicSM::DynamicSM(ReadyCount readyCount) {
-	m_RC = readyCount;
+#include "./google/btree_map.h"
 
-#ifdef USE_DYNAMIC_SM_BTREE_MAP
 #if !defined(CONTEXT_32_BIT) && !defined(CONTEXT_64_BIT)
-	m_SM = new btree::btree_map<context_t, ReadyCount, ContextComparer, std::allocator<context_t>>;
+
+struct ContextComparer: public btree::btree_key_compare_to_tag {
+		int operator()(const context_t &a, const context_t &b) const {
+			if (a.Outer == b.Outer && a.Middle == b.Middle && a.Inner == b.Inner)
+				return 0;
+			else {
+				if (a.Outer == b.Outer && a.Middle == b.Middle && a.Inner > b.Inner)
+					return 1;
+				else if (a.Outer == b.Outer && a.Middle != 0 && a.Middle > b.Middle)
+					return 1;
+				else if ((a.Outer != 0) && a.Outer > b.Outer)
+					return 1;
+				else
+					return -1;
+			}
+		}
+};
+
+struct DynamicSM_BTREEMAP::Map: public btree::btree_map<context_t, ReadyCount, ContextComparer, std::allocator<context_t>> {
+};
 #else
-	m_SM = new btree::btree_map<context_t, ReadyCount>;
-#endif
+struct DynamicSM_BTREEMAP::Map: public btree::btree_map<context_t, ReadyCount> {
+};
 #endif
+
+/**
+ * Creates the Dynamic SM using a BTREE map
+ * @param readyCount the ready count of the DThread
+ */
+DynamicSM_BTREEMAP::DynamicSM_BTREEMAP(ReadyCount readyCount) {
+	m_RC = readyCount;
+	m_SM = new Map;
 }
 
 /**
  * Deallocates the Dynamic SM's resources
  */
-DynamicSM::~DynamicSM() {
+DynamicSM_BTREEMAP::~DynamicSM_BTREEMAP() {
+	delete m_SM;
+}
+
+/**
+ * Updates an instance of the DThread
+ * @param context the Context attribute
+ * @return true if the DThread's instance is ready for execution
+ */
+bool DynamicSM_BTREEMAP::update(context_t context) {
+	auto got = m_SM->find(context);
+
+	// If Context-Ready Count pair is not found, allocate it
+	if (got == m_SM->end()) {
+		// Since we are allocating a new pair we decrease the RC by one. Notice that RC is >= 2
+		m_SM->insert(std::make_pair(context, m_RC - 1));
+
+		return false;
+	}
+	else {
+		// Decrease the value
+		--got->second;
 
+		if (got->second == 0) {
+			m_SM->erase(got); // Remove the pair
+			return true;
+		}
+		else
+			return false;
+	}
 }
 
-#endif
+/**
+ * Restores the initial Ready Counts of all the instances, i.e. removes the pending pairs
+ */
+void DynamicSM_BTREEMAP::reset() {
+	m_SM->clear();
+}
+
+#pragma GCC diagnostic pop
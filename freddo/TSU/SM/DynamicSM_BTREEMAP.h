@@ -25,7 +25,7 @@
  *      Author: geomat
  *
  * Description: This Dynamic SM is implemented using the google's and stx's btree map. Each DThread will
- * hold a different Dynamic SM of this type.
+ * hold a different Dynamic SM of this type. It is the BTREE_SM storage of the Dynamic SM (see DynamicSM.h).
  *
  * Reference: 1) https://code.google.com/p/cpp-btree/wiki/UsageInstructions
  * 						2) http://panthema.net/2007/stx-btree/
@@ -39,90 +39,37 @@
 #include "../../Error.h"
 #include <stdio.h>
 
-#include "./google/btree_map.h"
-
-#if defined (USE_DYNAMIC_SM_BTREE_MAP)
-
-using std::size_t;
-using std::hash;
-
-#if !defined(CONTEXT_32_BIT) && !defined(CONTEXT_64_BIT)
-
-struct ContextComparer: public btree::btree_key_compare_to_tag {
-		int operator()(const context_t &a, const context_t &b) const {
-			if (a.Outer == b.Outer && a.Middle == b.Middle && a.Inner == b.Inner)
-				return 0;
-			else {
-				if (a.Outer == b.Outer && a.Middle == b.Middle && a.Inner > b.Inner)
-					return 1;
-				else if (a.Outer == b.Outer && a.Middle != 0 && a.Middle > b.Middle)
-					return 1;
-				else if ((a.Outer != 0) && a.Outer > b.Outer)
-					return 1;
-				else
-					return -1;
-			}
-		}
-};
-#endif
-
-class DynamicSM {
+class DynamicSM_BTREEMAP {
 	public:
 
 		/**
-		 * Creates the Dynamic SM using an Unordered MAP
+		 * Creates the Dynamic SM using a BTREE map
 		 * @param readyCount the ready count of the DThread
 		 */
-		DynamicSM(ReadyCount readyCount);
+		DynamicSM_BTREEMAP(ReadyCount readyCount);
 
 		/**
 		 * Deallocates the Dynamic SM's resources
 		 */
-		~DynamicSM();
+		~DynamicSM_BTREEMAP();
 
 		/**
 		 * Updates an instance of the DThread
 		 * @param context the Context attribute
 		 * @return true if the DThread's instance is ready for execution
 		 */
-		bool update(context_t context) {
-			m_got = m_SM->find(context);
-
-			// If Context-Ready Count pair is not found, allocate it
-			if (m_got == m_SM->end()) {
-				// Since we are allocating a new pair we decrease the RC by one. Notice that RC is >= 2
-				m_SM->insert(std::make_pair(context, m_RC - 1));
+		bool update(context_t context);
 
-				return false;
-			}
-			else {
-				// Decrease the value
-				--m_got->second;
-
-				//printf("Second SM: %d\n", m_got->second);
-
-				if (m_got->second == 0) {
-					m_SM->erase(context); // Remove the pair
-					return true;
-				}
-				else
-					return false;
-			}
-		}
+		/**
+		 * Restores the initial Ready Counts of all the instances, i.e. removes the pending pairs
+		 */
+		void reset();
 
 	private:
+		struct Map;  // The btree map. It is defined in the source file, in order to keep the btree headers out of the applications.
 
-#if defined (CONTEXT_64_BIT) || defined (CONTEXT_32_BIT)
-		btree::btree_map<context_t, ReadyCount> ::iterator m_got;
-		btree::btree_map<context_t, ReadyCount>* m_SM;
-#else
-		btree::btree_map<context_t, ReadyCount, ContextComparer, std::allocator<context_t>>::iterator m_got;
-		btree::btree_map<context_t, ReadyCount, ContextComparer, std::allocator<context_t>>* m_SM;
-#endif
-
+		Map* m_SM;  // A dynamic SM implemented as a btree map
 		ReadyCount m_RC; // The Ready Count of the DThread
 };
 
-#endif
-
-#endif /* DYNAMICSM_UMAP_H_ */
+#endif /* DYNAMICSM_BTREEMAP_H_ */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * DynamicSM_FLATMAP.cpp
+ */
+
+#include "DynamicSM_FLATMAP.h"
+
+#include <new>
+#include <string.h>
+
+/**
+ * Creates the Dynamic SM using an open-addressing hash table
+ * @param readyCount the ready count of the DThread
+ * @param initialCapacity the initial number of slots of the table. It is rounded up to a power of 2.
+ */
+DynamicSM_FLATMAP::DynamicSM_FLATMAP(ReadyCount readyCount, size_t initialCapacity) {
+	size_t capacity = 8;
+
+	while (capacity < initialCapacity)
+		capacity <<= 1;
+
+	m_RC = readyCount;
+	allocateSlots(capacity);
+
+#ifdef TSU_COLLECT_STATISTICS
+	m_numberOfUpdates = 0;
+#endif
+}
+
+/**
+ * Deallocates the Dynamic SM's resources
+ */
+DynamicSM_FLATMAP::~DynamicSM_FLATMAP() {
+#ifdef TSU_COLLECT_STATISTICS
+	printf("Statistics of DynamicSM (FLATMAP) => number of updates:%d | number of slots:%lu\n", m_numberOfUpdates, m_mask + 1);
+#endif
+
+	delete[] m_slots;
+}
+
+/**
+ * Restores the initial Ready Counts of all the instances, i.e. removes the pending pairs. The slots are kept.
+ */
+void DynamicSM_FLATMAP::reset() {
+	// The table is already empty if all the instances became ready
+	if (m_size == 0)
+		return;
+
+	memset(m_slots, 0, (m_mask + 1) * sizeof(Slot));
+	m_size = 0;
+}
+
+/**
+ * Allocates the slots of the table
+ * @param capacity the number of slots. It has to be a power of 2.
+ */
+void DynamicSM_FLATMAP::allocateSlots(size_t capacity) {
+	try {
+		m_slots = new Slot[capacity]();  // All slots are empty (zero Ready Count)
+	}
+	catch (std::bad_alloc&) {
+		printf("Error in DynamicSM_FLATMAP => Memory allocation of %lu slots failed\n", capacity);
+		exit(ERROR);
+	}
+
+	m_mask = capacity - 1;
+	m_size = 0;
+	m_growThreshold = capacity / 4 * 3;
+}
+
+/**
+ * Doubles the number of slots of the table and re-inserts the stored pairs
+ */
+void DynamicSM_FLATMAP::grow() {
+	Slot* oldSlots = m_slots;
+	size_t oldCapacity = m_mask + 1;
+
+	allocateSlots(oldCapacity * 2);
+
+	for (size_t i = 0; i < oldCapacity; ++i)
+		if (oldSlots[i].readyCount != 0)
+			insert(oldSlots[i].context, oldSlots[i].readyCount);
+
+	delete[] oldSlots;
+}
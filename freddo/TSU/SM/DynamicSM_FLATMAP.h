@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * DynamicSM_FLATMAP.h
+ *
+ * Description: This Dynamic SM is implemented using an open-addressing hash table. The Context-Ready Count pairs are
+ * stored inline in a power-of-2 array of slots and the collisions are resolved with linear probing. Each DThread will
+ * hold a different Dynamic SM of this type. It is the HASH_SM storage of the Dynamic SM (see DynamicSM.h).
+ *
+ * Notes:
+ * 		- A slot with Ready Count 0 is empty, since a pair is removed when its Ready Count reaches zero
+ * 		- The pairs are removed with backward-shift deletion, i.e. no tombstones are left behind and the probe
+ * 		  sequences stay short without periodic rehashing
+ * 		- Memory is allocated only when the table grows. Once the table is large enough for the active instances,
+ * 		  the updates do not allocate or release memory.
+ */
+
+#ifndef DYNAMICSM_FLATMAP_H_
+#define DYNAMICSM_FLATMAP_H_
+
+// Includes
+#include "../../ddm_defs.h"
+#include "../../Error.h"
+#include <stdio.h>
+
+class DynamicSM_FLATMAP {
+	public:
+
+		/**
+		 * Creates the Dynamic SM using an open-addressing hash table
+		 * @param readyCount the ready count of the DThread
+		 * @param initialCapacity the initial number of slots of the table. It is rounded up to a power of 2.
+		 */
+		DynamicSM_FLATMAP(ReadyCount readyCount, size_t initialCapacity = DYNAMIC_SM_INITIAL_CAPACITY);
+
+		/**
+		 * Deallocates the Dynamic SM's resources
+		 */
+		~DynamicSM_FLATMAP();
+
+		/**
+		 * Updates an instance of the DThread
+		 * @param context the Context attribute
+		 * @return true if the DThread's instance is ready for execution
+		 */
+		inline bool update(context_t context) {
+#ifdef TSU_COLLECT_STATISTICS
+			m_numberOfUpdates++;
+#endif
+
+			size_t index = hashContext(context) & m_mask;
+
+			while (true) {
+				Slot& slot = m_slots[index];
+
+				// The Context-Ready Count pair is not found, allocate it
+				if (slot.readyCount == 0) {
+					// Since we are allocating a new pair we decrease the RC by one. Notice that RC is >= 2
+					if (m_size < m_growThreshold) {
+						slot.context = context;
+						slot.readyCount = m_RC - 1;
+						m_size++;
+					}
+					else {
+						grow();
+						insert(context, m_RC - 1);
+					}
+
+					return false;
+				}
+
+				if (slot.context == context) {
+					// Decrease the value and remove the pair if the instance is ready
+					if (--slot.readyCount == 0) {
+						erase(index);
+						return true;
+					}
+
+					return false;
+				}
+
+				index = (index + 1) & m_mask;
+			}
+		}
+
+		/**
+		 * Restores the initial Ready Counts of all the instances, i.e. removes the pending pairs. The slots are kept.
+		 */
+		void reset();
+
+	private:
+
+		// A Context-Ready Count pair. The slot is empty if its Ready Count is zero.
+		typedef struct {
+				context_t context;  // The context of the instance
+				ReadyCount readyCount;  // The remaining Ready Count of the instance
+		} Slot;
+
+		Slot* m_slots;  // The slots of the hash table
+		size_t m_mask;  // The number of slots minus one (the number of slots is a power of 2)
+		size_t m_size;  // The number of the pairs that are stored in the table
+		size_t m_growThreshold;  // The number of pairs above which the table doubles its size (load factor 3/4)
+		ReadyCount m_RC;  // The Ready Count of the DThread
+
+#ifdef TSU_COLLECT_STATISTICS
+		UInt m_numberOfUpdates;
+#endif
+
+		/**
+		 * @return the hash value of a context. The bits of the context are mixed, since the contexts of neighbouring instances
+		 * differ only in their low bits.
+		 * @param context the Context attribute
+		 */
+		static inline size_t hashContext(const context_t& context) {
+#if defined (CONTEXT_64_BIT) || defined (CONTEXT_32_BIT)
+			uint64_t h = (uint64_t) context;
+#else
+			uint64_t h = ((uint64_t) context.Outer * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t) context.Middle * 0xC2B2AE3D27D4EB4FULL) ^ (uint64_t) context.Inner;
+#endif
+
+			// The finalizer of MurmurHash3
+			h ^= h >> 33;
+			h *= 0xFF51AFD7ED558CCDULL;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ULL;
+			h ^= h >> 33;
+
+			return (size_t) h;
+		}
+
+		/**
+		 * Inserts a pair that does not exist in the table. The table has to have free slots.
+		 * @param context the Context attribute
+		 * @param readyCount the Ready Count of the instance
+		 */
+		inline void insert(const context_t& context, ReadyCount readyCount) {
+			size_t index = hashContext(context) & m_mask;
+
+			while (m_slots[index].readyCount != 0)
+				index = (index + 1) & m_mask;
+
+			m_slots[index].context = context;
+			m_slots[index].readyCount = readyCount;
+			m_size++;
+		}
+
+		/**
+		 * Removes the pair of a slot. The following pairs of the probe sequence are shifted backwards, in order to fill the hole.
+		 * @param index the index of the slot
+		 */
+		inline void erase(size_t index) {
+			size_t next = index;
+
+			while (true) {
+				next = (next + 1) & m_mask;
+
+				if (m_slots[next].readyCount == 0)
+					break;
+
+				// The pair can fill the hole only if the hole is between its home slot and its current slot
+				size_t home = hashContext(m_slots[next].context) & m_mask;
+
+				if (((next - home) & m_mask) >= ((next - index) & m_mask)) {
+					m_slots[index] = m_slots[next];
+					index = next;
+				}
+			}
+
+			m_slots[index].readyCount = 0;
+			m_size--;
+		}
+
+		/**
+		 * Doubles the number of slots of the table and re-inserts the stored pairs
+		 */
+		void grow();
+
+		/**
+		 * Allocates the slots of the table
+		 * @param capacity the number of slots. It has to be a power of 2.
+		 */
+		void allocateSlots(size_t capacity);
+};
+
+#endif /* DYNAMICSM_FLATMAP_H_ */
@@ -27,13 +27,11 @@
 
 #include "DynamicSM_UMAP.h"
 
-#if defined (USE_DYNAMIC_SM_UMAP) || defined (USE_DYNAMIC_SM_BOOST_UMAP)
-
 /**
  * Creates the Dynamic SM using an Unordered MAP
  * @param readyCount the ready count of the DThread
  */
-DynamicSM::DynamicSM(ReadyCount readyCount) {
+DynamicSM_UMAP::DynamicSM_UMAP(ReadyCount readyCount) {
 	m_RC = readyCount;
 	m_SM.reserve(8192); // Allocate some entries at the beginning in order to decrease rehashes
 
@@ -45,10 +43,8 @@ DynamicSM::DynamicSM(ReadyCount readyCount) {
 /**
  * Deallocates the Dynamic SM's resources
  */
-DynamicSM::~DynamicSM() {
+DynamicSM_UMAP::~DynamicSM_UMAP() {
 #ifdef TSU_COLLECT_STATISTICS
 	printf("Statistics of DynamicSM (UMAP) => number of updates:%d\n", m_numberOfUpdates);
 #endif
 }
-
-#endif
@@ -25,7 +25,8 @@
  *      Author: geomat
  *
  * Description: This Dynamic SM is implemented using an Unordered Map. Each DThread will
- * hold a different Dynamic SM of this type.
+ * hold a different Dynamic SM of this type. It is the SPARSE_SM storage of the Dynamic SM (see DynamicSM.h).
+ * The boost's unordered map is used if USE_DYNAMIC_SM_BOOST_UMAP is defined.
  */
 
 #ifndef DYNAMICSM_UMAP_H_
@@ -35,17 +36,15 @@
 #include "../../ddm_defs.h"
 #include "../../Error.h"
 #include <stdio.h>
+#include <pthread.h>
 
-
-#if defined(USE_DYNAMIC_SM_UMAP)
-	#include <unordered_map>
-#else
+#if defined (USE_DYNAMIC_SM_BOOST_UMAP)
 	//#include <boost/functional/hash.hpp>
 	#include <boost/unordered_map.hpp>
+#else
+	#include <unordered_map>
 #endif
 
-#if defined (USE_DYNAMIC_SM_UMAP) || defined (USE_DYNAMIC_SM_BOOST_UMAP)
-
 using std::size_t;
 using std::hash;
 
@@ -72,7 +71,7 @@ using std::hash;
 	};
 #endif
 
-class DynamicSM
+class DynamicSM_UMAP
 {
 	public:
 
@@ -80,12 +79,12 @@ class DynamicSM
 		 * Creates the Dynamic SM using an Unordered MAP
 		 * @param readyCount the ready count of the DThread
 		 */
-		DynamicSM(ReadyCount readyCount);
+		DynamicSM_UMAP(ReadyCount readyCount);
 
 		/**
 		 * Deallocates the Dynamic SM's resources
 		 */
-		~DynamicSM();
+		~DynamicSM_UMAP();
 
 		/**
 		 * Updates an instance of the DThread
@@ -122,6 +121,13 @@ class DynamicSM
 			}
 		}
 
+		/**
+		 * Restores the initial Ready Counts of all the instances, i.e. removes the pending pairs
+		 */
+		inline void reset() {
+			m_SM.clear();
+		}
+
 	private:
 
 		#ifdef TSU_COLLECT_STATISTICS
@@ -129,7 +135,7 @@ class DynamicSM
 		#endif
 
 		#if defined (CONTEXT_64_BIT) || defined (CONTEXT_32_BIT)
-				#if defined (USE_DYNAMIC_SM_UMAP)
+				#if !defined (USE_DYNAMIC_SM_BOOST_UMAP)
 					std::unordered_map<context_t, ReadyCount>::iterator m_got; 												 	// Iterator used for the unordered map
 					std::unordered_map<context_t, ReadyCount> m_SM;																		 	// A dynamic SM implemented as an unordered map
 				#else
@@ -137,7 +143,7 @@ class DynamicSM
 					boost::unordered_map<context_t, ReadyCount> m_SM;																		// A dynamic SM implemented as a boost unordered map
 				#endif
 		#else
-				#if defined (USE_DYNAMIC_SM_UMAP)
+				#if !defined (USE_DYNAMIC_SM_BOOST_UMAP)
 					std::unordered_map<context_t, ReadyCount, ContextHasher>::iterator m_got; 					// Iterator used for the unordered map
 					std::unordered_map<context_t, ReadyCount, ContextHasher> m_SM;											// A dynamic SM implemented as an unordered map
 				#else
@@ -149,6 +155,4 @@ class DynamicSM
 		ReadyCount m_RC; 																																				// The Ready Count of the DThread
 };
 
-#endif
-
 #endif /* DYNAMICSM_UMAP_H_ */
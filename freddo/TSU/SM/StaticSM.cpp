@@ -27,6 +27,9 @@
 
 #include "StaticSM.h"
 #include <iostream>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 using std::bad_alloc;
 
 /**
@@ -36,30 +39,95 @@ using std::bad_alloc;
  * @param[in] innerRange the range of the inner Context
  * @param[in] middleRange the range of the middle Context
  * @param[in] outerRange the range of the outer Context
+ * @param[in] domain the domain of the Contexts or nullptr if all the Contexts of the ranges are valid
  */
-StaticSM::StaticSM(Nesting nesting, ReadyCount readyCount, size_t innerRange, size_t middleRange, size_t outerRange) {
+StaticSM::StaticSM(Nesting nesting, ReadyCount readyCount, size_t innerRange, size_t middleRange, size_t outerRange, const ContextDomain* domain) {
+	m_RC = readyCount;
 	m_nesting = nesting;
 	m_innerRange = innerRange;
 	m_middleRange = middleRange;
 	m_outerRange = outerRange;
+	m_pendingInPage = nullptr;
+	m_mappedBytes = 0;
+	m_pageShift = 0;
+	m_domain = nullptr;
+	m_rowBase = nullptr;
 
 	size_t size = innerRange * middleRange * outerRange;
 
+	// Pack the Ready Counts of the domain row by row. The Nesting-0 SMs have a single entry.
+	if (domain && nesting != Nesting::ZERO) {
+		m_domain = new ContextDomain(*domain);
+		m_rowBase = new size_t[outerRange * middleRange];
+		size = 0;
+
+		for (size_t outer = 0; outer < outerRange; ++outer) {
+			for (size_t middle = 0; middle < middleRange; ++middle) {
+				size_t first, count;
+				m_domain->getInnerInterval(outer, middle, innerRange, first, count);
+
+				// The unsigned arithmetic wraps around, i.e. m_rowBase + Inner is the index of the Context
+				m_rowBase[outer * middleRange + middle] = size - first;
+				size += count;
+			}
+		}
+
+		// An empty domain allocates a single entry
+		if (size == 0)
+			size = 1;
+	}
+
+	m_size = size;
+	size_t bytes = size * sizeof(std::atomic<ReadyCount>);
+
 #ifdef TSU_COLLECT_STATISTICS
 	m_numberOfUpdates = 0;
 #endif
 
+	// Small SMs are allocated from the heap and they are initialized with zero consumed decrements
+	if (bytes < STATIC_SM_LAZY_MIN_SIZE) {
+		try {
+			m_consumed = new std::atomic<ReadyCount>[size];
+		}
+		catch (std::bad_alloc&) {
+			printf("Error while allocating Ready Counts of Static SM => Memory allocation failed\n");
+			exit(ERROR);
+		}
+
+		for (size_t i = 0; i < size; ++i)
+			m_consumed[i].store(0, std::memory_order_relaxed);
+
+		return;
+	}
+
+	// Large SMs are mapped on demand. The anonymous mappings are zero-filled, i.e. all the instances are untouched.
+	size_t pageSize = sysconf(_SC_PAGESIZE);
+	size_t readyCountsPerPage = pageSize / sizeof(std::atomic<ReadyCount>);
+	size_t numOfPages = (size + readyCountsPerPage - 1) / readyCountsPerPage;
+
+	while (((size_t) 1 << m_pageShift) < readyCountsPerPage)
+		m_pageShift++;
+
+	m_mappedBytes = numOfPages * pageSize;
+
+	void* memory = mmap(nullptr, m_mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+	if (memory == MAP_FAILED) {
+		printf("Error while allocating Ready Counts of Static SM => Mapping of %lu bytes failed\n", m_mappedBytes);
+		exit(ERROR);
+	}
+
+	m_consumed = static_cast<std::atomic<ReadyCount>*>(memory);
+
 	try {
-		m_rcMemory = new ReadyCount[size];
+		m_pendingInPage = new std::atomic<UInt>[numOfPages];
 	}
 	catch (std::bad_alloc&) {
-		printf("Error while allocating Ready Counts of Static SM => Memory allocation failed\n");
+		printf("Error while allocating the page counters of Static SM => Memory allocation failed\n");
 		exit(ERROR);
 	}
 
-	// Initializes the SM entries with the ready count value
-	for (size_t i = 0; i < size; ++i)
-		m_rcMemory[i] = readyCount;
+	resetPageCounters();
 }
 
 /**
@@ -71,5 +139,52 @@ StaticSM::~StaticSM() {
 	printf("Statistics of StaticSM => number of updates:%d\n", m_numberOfUpdates);
 #endif
 
-	delete[] m_rcMemory;
+	delete m_domain;
+	delete[] m_rowBase;
+
+	if (m_pendingInPage) {
+		munmap(m_consumed, m_mappedBytes);
+		delete[] m_pendingInPage;
+	}
+	else {
+		delete[] m_consumed;
+	}
+}
+
+/**
+ * Restores the initial Ready Counts of all the instances. The memory of the SM is reused.
+ */
+void StaticSM::reset() {
+	// The pages of the mapping are dropped, i.e. they become zero pages again without storing anything
+	if (m_pendingInPage) {
+		madvise(m_consumed, m_mappedBytes, MADV_DONTNEED);
+		resetPageCounters();
+		return;
+	}
+
+	// The SM is not accessed concurrently during the reset, thus it is cleared with (vectorized) plain stores
+	memset((void*) m_consumed, 0, m_size * sizeof(std::atomic<ReadyCount>));
+}
+
+/**
+ * Sets the number of the pending instances of each page to the number of its Ready Counts
+ */
+void StaticSM::resetPageCounters() {
+	size_t readyCountsPerPage = (size_t) 1 << m_pageShift;
+	size_t numOfPages = (m_size + readyCountsPerPage - 1) / readyCountsPerPage;
+
+	for (size_t i = 0; i < numOfPages; ++i)
+		m_pendingInPage[i].store(readyCountsPerPage, std::memory_order_relaxed);
+
+	// The last page may be partially used
+	m_pendingInPage[numOfPages - 1].store(m_size - (numOfPages - 1) * readyCountsPerPage, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the physical memory of a page to the OS. The page is mapped again (zero-filled) if it is accessed.
+ * @param[in] page the index of the page
+ */
+void StaticSM::releasePage(size_t page) {
+	size_t pageSize = sizeof(std::atomic<ReadyCount>) << m_pageShift;
+	madvise(reinterpret_cast<char*>(m_consumed) + page * pageSize, pageSize, MADV_DONTNEED);
 }
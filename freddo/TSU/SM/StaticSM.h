@@ -25,6 +25,16 @@
  *      Author: geomat
  *
  * Description: The Static Synchronization Memory (SM) is an entity that holds the Ready Counts (RCs) of a DThread.
+ *
+ * Notes:
+ * 		- The SM stores the number of the consumed decrements of each instance instead of its remaining Ready Count, i.e.
+ * 		  an untouched instance holds zero and the SM does not have to be initialized
+ * 		- The SMs that are larger than STATIC_SM_LAZY_MIN_SIZE are allocated with mmap. Their pages are mapped on their
+ * 		  first update (an untouched page is the zero page) and they are released when all their instances become
+ * 		  ready. Thus, the resident memory of the SM follows the active wavefront of the DThread.
+ * 		- If a Context domain is provided (see ContextDomain.h), only the Ready Counts of the domain are stored. The Ready
+ * 		  Counts of each row (Outer and Middle parts) are packed and the index of a Context is the offset of its row plus
+ * 		  its Inner part, e.g. a tetrahedral 3D domain needs about 1/6 of the memory of its ranges.
  */
 
 #ifndef STATISM_H_
@@ -32,6 +42,8 @@
 
 #include "../../ddm_defs.h"
 #include "../../Error.h"
+#include "ContextDomain.h"
+#include <atomic>
 
 class StaticSM {
 	public:
@@ -43,8 +55,9 @@ class StaticSM {
 		 * @param[in] innerRange the range of the inner Context
 		 * @param[in] middleRange the range of the middle Context
 		 * @param[in] outerRange the range of the outer Context
+		 * @param[in] domain the domain of the Contexts or nullptr if all the Contexts of the ranges are valid
 		 */
-		StaticSM(Nesting nesting, ReadyCount readyCount, size_t innerRange, size_t middleRange, size_t outerRange);
+		StaticSM(Nesting nesting, ReadyCount readyCount, size_t innerRange, size_t middleRange, size_t outerRange, const ContextDomain* domain = nullptr);
 
 		/**
 		 *	Releases the memory allocated by the static Synchronization Memory (SM)
@@ -54,111 +67,226 @@ class StaticSM {
 		/**
 		 * Decreases the Ready Count of the corresponded Context by one
 		 * @param[in] context the Context attribute
+		 * @return true if the Ready Count reached zero, i.e. the DThread's instance is ready for execution
 		 * @note Before the update operation check if the Context is valid. Also check if the
 		 * Ready Count of the specific Context is not already Zero.
 		 */
-		inline void update(context_t context) {
+		inline bool update(context_t context) {
 
 #ifdef TSU_COLLECT_STATISTICS
 			m_numberOfUpdates++;
 #endif
 
-			size_t index = 0;
+			// Only one thread (the TSU) updates the SM in this case, thus a plain increment is enough
+			size_t index = getIndex(context);
+			std::atomic<ReadyCount>& consumed = m_consumed[index];
+			ReadyCount value = consumed.load(std::memory_order_relaxed) + 1;
+
+			consumed.store(value, std::memory_order_relaxed);
+
+			if (value != m_RC)
+				return false;
+
+			instanceCompleted(index);
+			return true;
+		}
+
+		/**
+		 * Decreases atomically the Ready Count of the corresponded Context by one. It is used when the
+		 * Kernels apply their updates concurrently (decentralized updates).
+		 * @param[in] context the Context attribute
+		 * @return true if the Ready Count reached zero, i.e. the DThread's instance is ready for execution
+		 * @note Before the update operation check if the Context is valid
+		 */
+		inline bool atomicUpdate(context_t context) {
+			size_t index = getIndex(context);
+
+			if (m_consumed[index].fetch_add(1, std::memory_order_acq_rel) + 1 != m_RC)
+				return false;
+
+			instanceCompleted(index);
+			return true;
+		}
+
+		/**
+		 * Restores the initial Ready Counts of all the instances. The memory of the SM is reused.
+		 * @note The SM must not be updated during the reset
+		 */
+		void reset();
+
+		/**
+		 * Retrieves the Ready Count of a specific Context
+		 * @param context the Context attribute
+		 * @return the Ready Count value
+		 * @note The instances of a released page report the initial Ready Count
+		 */
+		inline ReadyCount getReadyCount(context_t context) const {
+			return m_RC - m_consumed[getIndex(context)].load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * Checks if the Context is valid
+		 * @param context the Context attribute
+		 * @return true if the Context is valid
+		 */
+		inline bool isContextValid(context_t context) const {
+			bool isValid = false;
 
 			switch (m_nesting) {
 				case Nesting::ONE:
 					case Nesting::CONTINUATION:
-					index = GET_N1(context);
+					isValid = GET_N1(context) < m_innerRange;
 					break;
 
 				case Nesting::TWO:
-					index = GET_N2_OUTER(context) * m_innerRange + GET_N2_INNER(context);
+					isValid = GET_N2_INNER(context) < m_innerRange && GET_N2_OUTER(context) < m_outerRange;
 					break;
 
 				case Nesting::THREE:
-					index = (GET_N3_OUTER(context) * m_middleRange + GET_N3_MIDDLE(context)) * m_innerRange + GET_N3_INNER(context);
+					isValid = GET_N3_INNER(context) < m_innerRange && GET_N3_OUTER(context) < m_outerRange && GET_N3_MIDDLE(context) < m_middleRange;
 					break;
 
 					// For Nesting-0 (the context is always zero). Nesting-Recursive should not used any SM type.
 				default:
-					index = 0;
-					break;
+					context_t c = CREATE_N0();
+					return (c == context);
 			}
 
-			--m_rcMemory[index];
+			if (!isValid || !m_domain)
+				return isValid;
+
+			int64_t outer, middle, inner;
+			getParts(context, outer, middle, inner);
+
+			return m_domain->contains(outer, middle, inner);
 		}
 
 		/**
-		 * Retrieves the Ready Count of a specific Context
-		 * @param context the Context attribute
-		 * @return the Ready Count value
+		 * Checks if all the Contexts of a range are valid
+		 * @param context the start of the range
+		 * @param maxContext the end of the range
+		 * @return true if all the Contexts are valid
+		 * @note The domain is convex, thus it contains the range if it contains the corners of the range
 		 */
-		inline ReadyCount getReadyCount(context_t context) const {
-			size_t index = 0;
+		inline bool isRangeValid(context_t context, context_t maxContext) const {
+			if (!m_domain)
+				return isContextValid(context) && isContextValid(maxContext);
+
+			if (!isContextValid(context) || !isContextValid(maxContext))
+				return false;
+
+			int64_t low[3], high[3];  // Indexed by ContextPart
+			getParts(context, low[OUTER_CONTEXT], low[MIDDLE_CONTEXT], low[INNER_CONTEXT]);
+			getParts(maxContext, high[OUTER_CONTEXT], high[MIDDLE_CONTEXT], high[INNER_CONTEXT]);
+
+			int valid = 1;
+
+			for (UInt corner = 0; corner < 8; ++corner)
+				valid &= m_domain->contains((corner & 4) ? high[OUTER_CONTEXT] : low[OUTER_CONTEXT], (corner & 2) ? high[MIDDLE_CONTEXT] : low[MIDDLE_CONTEXT],
+				    (corner & 1) ? high[INNER_CONTEXT] : low[INNER_CONTEXT]);
+
+			return valid;
+		}
+
+	private:
+		std::atomic<ReadyCount>* m_consumed;  // The memory that holds the consumed decrements of the Ready Count values
+		ReadyCount m_RC;  // The Ready Count of the DThread
+		size_t m_size;  // The number of the Ready Counts
+		Nesting m_nesting;  // The nesting of the DThread
+		size_t m_innerRange;
+		size_t m_middleRange;
+		size_t m_outerRange;
+		ContextDomain* m_domain;  // The domain of the Contexts or nullptr if all the Contexts of the ranges are valid
+		size_t* m_rowBase;  // The index of the Context with Inner part zero of each row of the domain (offset of the row minus its first Inner part)
+
+		// Used only by the SMs that are allocated with mmap (m_pendingInPage is nullptr otherwise)
+		std::atomic<UInt>* m_pendingInPage;  // The number of instances of each page that are not ready yet
+		size_t m_mappedBytes;  // The size of the mapping
+		size_t m_pageShift;  // log2 of the number of Ready Counts per page
+
+#ifdef TSU_COLLECT_STATISTICS
+		UInt m_numberOfUpdates;
+#endif
+
+		/**
+		 * Called when an instance becomes ready. The page of the instance is released if all its instances are ready, since
+		 * they will not be updated again.
+		 * @param[in] index the index of the instance's Ready Count
+		 */
+		inline void instanceCompleted(size_t index) {
+			if (m_pendingInPage && m_pendingInPage[index >> m_pageShift].fetch_sub(1, std::memory_order_acq_rel) == 1)
+				releasePage(index >> m_pageShift);
+		}
+
+		/**
+		 * Returns the physical memory of a page to the OS. The page is mapped again (zero-filled) if it is accessed.
+		 * @param[in] page the index of the page
+		 */
+		void releasePage(size_t page);
+
+		/**
+		 * Sets the number of the pending instances of each page to the number of its Ready Counts
+		 */
+		void resetPageCounters();
+
+		/**
+		 * Retrieves the parts of a Context. The missing parts of the Nesting-1 and Nesting-2 Contexts are zero.
+		 * @param[in] context the Context attribute
+		 * @param[out] outer the Outer part
+		 * @param[out] middle the Middle part
+		 * @param[out] inner the Inner part
+		 */
+		inline void getParts(context_t context, int64_t& outer, int64_t& middle, int64_t& inner) const {
+			outer = middle = inner = 0;
 
 			switch (m_nesting) {
 				case Nesting::ONE:
 					case Nesting::CONTINUATION:
-					index = GET_N1(context);
+					inner = GET_N1(context);
 					break;
 
 				case Nesting::TWO:
-					index = GET_N2_OUTER(context) * m_innerRange + GET_N2_INNER(context);
+					outer = GET_N2_OUTER(context);
+					inner = GET_N2_INNER(context);
 					break;
 
 				case Nesting::THREE:
-					index = (GET_N3_OUTER(context) * m_middleRange + GET_N3_MIDDLE(context)) * m_innerRange + GET_N3_INNER(context);
+					outer = GET_N3_OUTER(context);
+					middle = GET_N3_MIDDLE(context);
+					inner = GET_N3_INNER(context);
 					break;
 
-					// For Nesting-0 (the context is always zero). Nesting-Recursive should not used any SM type.
 				default:
-					index = 0;
 					break;
 			}
-
-			return m_rcMemory[index];
 		}
 
 		/**
-		 * Checks if the Context is valid
-		 * @param context the Context attribute
-		 * @return true if the Context is valid
+		 * @return the index of the Ready Count of a specific Context
 		 */
-		inline bool isContextValid(context_t context) const {
+		inline size_t getIndex(context_t context) const {
 			switch (m_nesting) {
 				case Nesting::ONE:
 					case Nesting::CONTINUATION:
-					return GET_N1(context) < m_innerRange;
-					break;
+					return m_rowBase ? m_rowBase[0] + GET_N1(context) : GET_N1(context);
 
 				case Nesting::TWO:
-					return GET_N2_INNER(context) < m_innerRange && GET_N2_OUTER(context) < m_outerRange;
-					break;
+					if (m_rowBase)
+						return m_rowBase[GET_N2_OUTER(context)] + GET_N2_INNER(context);
+
+					return GET_N2_OUTER(context) * m_innerRange + GET_N2_INNER(context);
 
 				case Nesting::THREE:
-					return GET_N3_INNER(context) < m_innerRange && GET_N3_OUTER(context) < m_outerRange && GET_N3_MIDDLE(context) < m_middleRange;
-					break;
+					if (m_rowBase)
+						return m_rowBase[GET_N3_OUTER(context) * m_middleRange + GET_N3_MIDDLE(context)] + GET_N3_INNER(context);
+
+					return (GET_N3_OUTER(context) * m_middleRange + GET_N3_MIDDLE(context)) * m_innerRange + GET_N3_INNER(context);
 
 					// For Nesting-0 (the context is always zero). Nesting-Recursive should not used any SM type.
 				default:
-					context_t c = CREATE_N0();
-					return (c == context);
-					break;
+					return 0;
 			}
-
-			return false;
 		}
-
-	private:
-		ReadyCount* m_rcMemory;  // The memory that holds the Ready Count values
-		Nesting m_nesting;  // The nesting of the DThread
-		size_t m_innerRange;
-		size_t m_middleRange;
-		size_t m_outerRange;
-
-#ifdef TSU_COLLECT_STATISTICS
-		UInt m_numberOfUpdates;
-#endif
 };
 
 #endif /* STATISM_H_ */
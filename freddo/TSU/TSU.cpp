@@ -43,25 +43,36 @@ TSU::TSU(unsigned int kernels, UInt affinityCore, UInt numofPeers, bool enablePi
 		Auxiliary::setThreadAffinity(pthread_self(), affinityCore);
 
 	// The minimum Thread ID is 1
-	m_tidCounter = 1;
+
+	m_workStealing = false;
+
+	// By default the idle threads busy-wait
+	setIdlePolicy(UINT_MAX, 0, false, DEFAULT_PARK_TIMEOUT);
+
+	// The Input Queues are drained in bursts
+	m_burstSize = DEFAULT_IQ_BURST;
+
+	// By default the Ready Counts are decremented only by the TSU
+	m_decentralizedUpdates = false;
+	m_directExecution = false;
+	m_pendingInDeques = 0;
 
 	try {
-		// Create the Kernels and the Input Queues
+		// Create the Kernels
 		m_kernels = new Kernel*[m_kernelsNum];
-		m_InputQueues = new InputQueue*[m_kernelsNum];
-		m_UnlimitedIQs = new queue<IQ_Entry>*[m_kernelsNum];
 
-		for (UInt i = 0; i < m_kernelsNum; ++i) {
-			m_kernels[i] = new Kernel(i, numofPeers);
-			m_InputQueues[i] = new InputQueue();
-			m_UnlimitedIQs[i] = new queue<IQ_Entry>();
-		}
+		for (UInt i = 0; i < m_kernelsNum; ++i)
+			m_kernels[i] = new Kernel(i, numofPeers, &m_pendingInDeques, &m_idlePolicy);
 	}
 	catch (std::bad_alloc&) {
 		printf("Error in TSU constructor => Memory allocation failed\n");
 		exit(ERROR);
 	}
 
+	// By default a single TSU thread applies all the updates
+	m_areShardsFinished = true;
+	createShards(1);
+
 #ifdef PROTECT_TT
 	if (pthread_mutex_init(&m_ttMutex, NULL) != 0) {
 		printf("Error in TSU constructor => Mutex m_ttMutex failed to be initialized\n");
@@ -98,16 +109,157 @@ void TSU::stopKernels() {
  * Deallocates the TSU's resources
  */
 TSU::~TSU() {
-	// Deallocate the Kernels and the Input Queues
-	for (UInt i = 0; i < m_kernelsNum; ++i) {
+	// Deallocate the Kernels and the TSU threads (with their Input Queues)
+	for (UInt i = 0; i < m_kernelsNum; ++i)
 		delete m_kernels[i];
-		delete m_InputQueues[i];
-		delete m_UnlimitedIQs[i];
-	}
 
 	delete[] m_kernels;
-	delete[] m_InputQueues;
-	delete[] m_UnlimitedIQs;
+	deleteShards();
+}
+
+/**
+ * Sets the number of the TSU threads (shards). The thread s applies the updates of the DThreads with tid % threads == s and it
+ * inserts ready DThreads in the Output Queues of the Kernels with kernelID % threads == s.
+ * @param[in] threads the number of the TSU threads. It is limited to the number of the Kernels and it is 1 in distributed mode.
+ * @note call this function before starting the Kernels
+ */
+void TSU::setSchedulerThreads(UInt threads) {
+	if (threads == 0) {
+		printf("Error while setting the TSU threads => The number of the TSU threads has to be greater than zero.\n");
+		exit(ERROR);
+	}
+
+	// Each TSU thread needs at least one Kernel for its ready DThreads. The remote updates are applied only by the first thread.
+	if (threads > m_kernelsNum)
+		threads = m_kernelsNum;
+
+	if (m_supportDistributed)
+		threads = 1;
+
+	if (threads == m_shardsNum)
+		return;
+
+	deleteShards();
+	createShards(threads);
+}
+
+/**
+ * Creates the TSU threads (shards) and connects the Kernels with the threads that fill their Output Queues
+ * @param[in] threads the number of the TSU threads
+ */
+void TSU::createShards(UInt threads) {
+	m_shardsNum = threads;
+
+	try {
+		m_shards = new TSUShard*[m_shardsNum];
+
+		for (UInt s = 0; s < m_shardsNum; ++s)
+			m_shards[s] = new TSUShard(this, s, m_shardsNum, m_kernelsNum, &m_spillBudget);
+	}
+	catch (std::bad_alloc&) {
+		printf("Error while creating the TSU threads => Memory allocation failed\n");
+		exit(ERROR);
+	}
+
+	for (UInt i = 0; i < m_kernelsNum; ++i)
+		m_kernels[i]->setTSUDoorbells(&m_shards[0]->doorbell, &m_shards[i % m_shardsNum]->doorbell);
+}
+
+/**
+ * Deallocates the TSU threads (shards)
+ */
+void TSU::deleteShards() {
+	for (UInt s = 0; s < m_shardsNum; ++s)
+		delete m_shards[s];
+
+	delete[] m_shards;
+}
+
+/**
+ * Restores the initial Ready Counts of all the DThreads, such as, the Dependency Graph can be executed again
+ * @note it has to be called when the DThreads are not executed, i.e. before or after the run functions
+ */
+void TSU::resetGraph() {
+	for (TID tid = 1; tid < m_TemplateMemory.getTIDBound(); ++tid) {
+		ThreadTemplate* threadTemplate = m_TemplateMemory.getTemplate(tid);
+
+		if (threadTemplate)
+			m_TemplateMemory.resetTemplate(threadTemplate);
+	}
+}
+
+/**
+ * Starts the TSU threads 1 to M-1
+ */
+void TSU::startShards() {
+	m_areShardsFinished = false;
+
+	for (UInt s = 1; s < m_shardsNum; ++s) {
+		m_shards[s]->isIdle.store(false);
+
+		if (pthread_create(&m_shards[s]->pthreadID, NULL, runShard, (void*) m_shards[s]) != 0) {
+			printf("Error: The TSU thread %d failed to start.\n", s);
+			perror("TSU::startShards -> pthread_create");
+			exit(ERROR);
+		}
+	}
+}
+
+/**
+ * Stops the TSU threads 1 to M-1 and waits for them to finish
+ */
+void TSU::stopShards() {
+	m_areShardsFinished = true;
+
+	for (UInt s = 1; s < m_shardsNum; ++s) {
+		m_shards[s]->doorbell.ring();
+		pthread_join(m_shards[s]->pthreadID, NULL);
+	}
+}
+
+/**
+ * The operation of the TSU threads 1 to M-1. Each one applies the updates of its DThreads until the execution is finished.
+ * @param[in] arg the shard of the thread
+ */
+void* TSU::runShard(void* arg) {
+	TSUShard& shard = *(TSUShard*) arg;
+	TSU* tsu = shard.tsu;
+	IdleBackoff backoff;
+	bool isExecuted;
+
+	while (!tsu->m_areShardsFinished) {
+		// The thread leaves the idle state only if it has updates, since the termination check of the thread 0 waits for the idle threads
+		if (shard.isIdle.load(std::memory_order_relaxed)) {
+			if (!tsu->hasUpdates(shard)) {
+				backoff.idle(tsu->m_idlePolicy, shard.doorbell, [&]() {return tsu->m_areShardsFinished || tsu->hasUpdates(shard);});
+				continue;
+			}
+
+			shard.activations.fetch_add(1);
+			shard.isIdle.store(false);
+			backoff.reset();
+		}
+
+		isExecuted = tsu->getUpdatesAndExecute(shard);
+
+		// Move the ready instances that did not fit in the Output Queues
+		if (shard.readyBacklogSize != 0 && tsu->drainReadyBacklogs(shard))
+			isExecuted = true;
+
+		if (isExecuted) {
+			backoff.reset();
+		}
+		else if (shard.readyBacklogSize == 0) {
+			shard.isIdle.store(true);
+			tsu->wakeUp();  // Let the thread 0 check if the execution is finished
+		}
+		else {
+			// Wait for the Kernels to drain their Output Queues
+			backoff.idle(tsu->m_idlePolicy, shard.doorbell, [&]() {return tsu->m_areShardsFinished || tsu->hasUpdates(shard) || tsu->canDrainReadyBacklogs(shard);});
+		}
+	}
+
+	return NULL;
 }
 
 /**
@@ -119,29 +271,34 @@ void TSU::runDist(NetworkManager* net) {
 	LOG_TSU("Distributed TSU Execution - Start.");
 
 	// Local Variables
-	UInt i;
-	bool isFinished;
+	TSUShard& shard = *m_shards[0];  // A single TSU thread is used in distributed mode
+	bool isFinished, isExecuted;
+	IdleBackoff backoff;
 
 	// Update the DThreads until there is no data in any TSU's queue (Input and Output Queues)
 	do {
-		isFinished = true;
-
 		// Executes updates until something is wrong (for example, when an Output Queue is full)
-		getUpdatesAndExecute();
+		isExecuted = getUpdatesAndExecute(shard);
 
-		for (i = 0; i < m_kernelsNum; ++i) {
-			if (!m_kernels[i]->isOutputQueueEmpty() || !m_InputQueues[i]->isEmpty() || !m_UnlimitedIQs[i]->empty()) {
-				isFinished = false;
-				break;
-			}
-		}
+		// Move the ready instances that did not fit in the Output Queues
+		if (shard.readyBacklogSize != 0 && drainReadyBacklogs(shard))
+			isExecuted = true;
+
+		if (isExecuted)
+			backoff.reset();
+
+		isFinished = !hasPendingWork();
 
 		// The Remote Input Queue and Unlimited IQ should be empty too
-		m_idle = isFinished && m_remoteInputQueue.isEmpty() && m_UnlimitedRIQ.empty();
+		m_idle = isFinished && m_remoteInputQueue.isEmpty() && m_UnlimitedRIQ.isEmpty();
 
 		if (m_idle) {
 			net->doTerminationProbing();
 		}
+
+		// Wait for new updates, for the Kernels to finish their work or for a message of the Network Manager
+		if (!isExecuted)
+			backoff.idle(m_idlePolicy, shard.doorbell, [&]() {return m_isDistFinished || hasUpdates(shard) || canDrainReadyBacklogs(shard) || (!m_idle && areKernelsIdle());});
 	}
 	while (!m_isDistFinished);
 
@@ -150,26 +307,65 @@ void TSU::runDist(NetworkManager* net) {
 
 /**
  * Stores the next IQ_Entry in the iqEntry pointer.
- * The functions selects the data from the IQs and UIQs in a round-robin fashion.
+ * The functions selects the data from the IQs and UIQs in a round-robin fashion. Only the queues that are marked in the
+ * Pending Work Map of the TSU thread are visited. The entries of each queue are dequeued in bursts.
  * If the IQs and UIQs are empty we are selecting data from the Remote IQ in the
  * case we are in distributed mode.
+ * @param[in] shard the TSU thread that owns the queues
  * @param iqEntry
+ * @param[out] producer the ID of the Kernel that sent the update or NO_KERNEL_ID if the update is remote or it came from another TSU thread
  * @return false if there is no IQ_Entry available
  */
-bool TSU::rrScheduler(IQ_Entry* iqEntry) {
-	static UInt rrIndex = 0;  // The current index of the Input Queue that the Round Robin scheduler use
+bool TSU::rrScheduler(TSUShard& shard, IQ_Entry* iqEntry, KernelID* producer) {
+	// Continue with the burst of the current Input Queue
+	if (shard.burstIndex < shard.burstCount) {
+		*iqEntry = shard.burst[shard.burstIndex++];
+		*producer = shard.burstProducer;
+		return true;
+	}
 
-	for (UInt attemptsLeft = m_kernelsNum; attemptsLeft != 0; attemptsLeft--) {
-		rrIndex = (rrIndex + 1) % m_kernelsNum;
+	const UInt queuesNum = shard.queuesNum;
 
-		if (!m_InputQueues[rrIndex]->isEmpty()) {
-			m_InputQueues[rrIndex]->dequeue(iqEntry);  // Dequeue the head entry from the selected Input Queue
-			return true;
+	for (UInt attemptsLeft = queuesNum; attemptsLeft != 0; attemptsLeft--) {
+		// Select the next queue that has pending updates
+		UInt next = shard.pendingUpdates->findNext((shard.rrIndex + 1 == queuesNum) ? 0 : shard.rrIndex + 1);
+
+		if (next == NO_PENDING_WORK) {
+			// Check one queue that may have been left unmarked by its producer (see PendingWorkMap.h)
+			shard.sweepIndex = (shard.sweepIndex + 1 == queuesNum) ? 0 : shard.sweepIndex + 1;
+
+			if (shard.inputQueues[shard.sweepIndex]->isEmpty() && shard.unlimitedIQs[shard.sweepIndex]->isEmpty())
+				break;
+
+			next = shard.sweepIndex;
 		}
 
-		if (!m_UnlimitedIQs[rrIndex]->empty()) {
-			*iqEntry = m_UnlimitedIQs[rrIndex]->front();  // Peek the head entry from the selected Unlimited Input Queue
-			m_UnlimitedIQs[rrIndex]->pop();  // Pop the entry immediately
+		shard.rrIndex = next;
+
+		InputQueue* iq = shard.inputQueues[next];
+		UnlimitedInputQueue* uiq = shard.unlimitedIQs[next];
+
+		// Dequeue a burst of entries from the selected Input Queue
+		shard.burstCount = iq->dequeue(shard.burst, m_burstSize);
+
+		// Move the entries of the selected Unlimited Input Queue in the burst
+		if (shard.burstCount < m_burstSize)
+			shard.burstCount += uiq->dequeue(shard.burst + shard.burstCount, m_burstSize - shard.burstCount);
+
+		// The queues are drained. Clear the mark and check again for the updates that were sent in the meantime.
+		if (shard.burstCount < m_burstSize) {
+			shard.pendingUpdates->clear(next);
+
+			if (!iq->isEmpty() || !uiq->isEmpty())
+				shard.pendingUpdates->mark(next);
+		}
+
+		if (shard.burstCount != 0) {
+			// The links carry ready instances from the other TSU threads
+			shard.burstProducer = (next < m_kernelsNum) ? next : NO_KERNEL_ID;
+			shard.burstIndex = 1;
+			*iqEntry = shard.burst[0];
+			*producer = shard.burstProducer;
 			return true;
 		}
 	}
@@ -179,12 +375,12 @@ bool TSU::rrScheduler(IQ_Entry* iqEntry) {
 	 */
 	if (m_supportDistributed & !m_remoteInputQueue.isEmpty()) {
 		m_remoteInputQueue.dequeue(iqEntry);
+		*producer = NO_KERNEL_ID;  // The update comes from a remote peer
 		return true;
 	}
 
-	if (m_supportDistributed & !m_UnlimitedRIQ.empty()) {
-		*iqEntry = m_UnlimitedRIQ.front();  // Peek the head entry from the Unlimited RIQ
-		m_UnlimitedRIQ.pop();  // Pop the entry immediately
+	if (m_supportDistributed && m_UnlimitedRIQ.dequeue(iqEntry)) {
+		*producer = NO_KERNEL_ID;  // The update comes from a remote peer
 		return true;
 	}
 
@@ -192,132 +388,166 @@ bool TSU::rrScheduler(IQ_Entry* iqEntry) {
 }
 
 /**
- * @return true if all the Input Queues and Unlimited Input Queues are empty
- */
-bool TSU::allIQsAreEmpty() {
-	for (UInt i = 0; i < m_kernelsNum; ++i) {
-		if (!m_InputQueues[i]->isEmpty() || !m_UnlimitedIQs[i]->empty())
-			return false;
-	}
-
-	return true;
-}
-
-/**
- *	Gets the update commands from the Input Queues in a Round-Robin fashion and execute them.
+ *	Gets the update commands from the Input Queues of a TSU thread in a Round-Robin fashion and execute them.
+ *	@param[in] shard the TSU thread
+ *	@return true if at least one update command is executed
  */
-void TSU::getUpdatesAndExecute(void) {
+bool TSU::getUpdatesAndExecute(TSUShard& shard) {
 	IQ_Entry iqEntry;
 
 	// Initialize the IQ entry
 	iqEntry.tid = 0;
-	iqEntry.isMultiple = false;
+	iqEntry.type = IQ_SINGLE_UPDATE;
 	iqEntry.context = CREATE_N0();
 	iqEntry.maxContext = CREATE_N0();
 
-	ThreadTemplate* threadTemplate;
-	StaticSM* synchMemory;
-	bool isFastExecute = false;
+	KernelID producer = NO_KERNEL_ID;  // The Kernel that sent the update
+	bool isExecuted = false;  // Indicates if at least one update command is executed
 
 	while (true) {
 
 		// If all Input Queues and Unlimited IQs are empty stop the update operation
-		if (rrScheduler(&iqEntry) == false)  // Get the next non-empty Input Queue
+		if (rrScheduler(shard, &iqEntry, &producer) == false)  // Get the next non-empty Input Queue
 			break;
 
-		// Get the thread template of the DThread that is going to be updated
-		threadTemplate = m_TemplateMemory.getTemplate(iqEntry.tid);
+		isExecuted = true;
 
-		if (!threadTemplate) {
-			printf("Error while updating => The DThread with id: %d does not exists.\n", iqEntry.tid);
-			exit(ERROR);
+		// Free Output Queue slots are given to the instances that are waiting in the Ready Backlogs first
+		if (shard.readyBacklogSize != 0)
+			drainReadyBacklogs(shard);
+
+		// A multicast entry is expanded to one update for each consumer of the producer DThread (iqEntry.tid)
+		if (iqEntry.type == IQ_MULTICAST_UPDATE || iqEntry.type == IQ_MULTICAST_MULTIPLE_UPDATE) {
+			const TID* cons = nullptr;
+			UInt numOfCons = getConsumerArray(iqEntry.tid, &cons);
+
+			iqEntry.type = (iqEntry.type == IQ_MULTICAST_UPDATE) ? IQ_SINGLE_UPDATE : IQ_MULTIPLE_UPDATE;
+
+			for (UInt i = 0; i < numOfCons; ++i) {
+				iqEntry.tid = cons[i];
+				executeUpdate(shard, iqEntry, producer);
+			}
+
+			continue;
 		}
 
-		// If the RC=1 then update without using any SM
-		isFastExecute = (threadTemplate->readyCount == 1);
+		executeUpdate(shard, iqEntry, producer);
+	}  // End of While
+
+	return isExecuted;
+}
+
+/**
+ * Executes an update command, i.e. decrements the Ready Count(s) of the DThread's instance(s) or schedules a ready instance
+ * @param[in] shard the TSU thread that executes the update
+ * @param[in] iqEntry the update command. Multicast entries are expanded before calling this function.
+ * @param[in] producer the ID of the Kernel that sent the update or NO_KERNEL_ID if the update is remote
+ */
+void TSU::executeUpdate(TSUShard& shard, const IQ_Entry& iqEntry, KernelID producer) {
+	ThreadTemplate* threadTemplate;
+	StaticSM* synchMemory;
+	bool isFastExecute = false;
+
+	// Get the thread template of the DThread that is going to be updated
+	threadTemplate = m_TemplateMemory.getTemplate(iqEntry.tid);
 
-		///////////// Update the DThreads /////////////
-		synchMemory = threadTemplate->SM;  // Get the Static SM of a DThread if exists
+	if (!threadTemplate) {
+		printf("Error while updating => The DThread with id: %d does not exists.\n", iqEntry.tid);
+		exit(ERROR);
+	}
 
-		// For multiple updates. The DThreads with RC=1 are scheduled immediately.
-		if (iqEntry.isMultiple) {
+	// The instance became ready by a Kernel (decentralized updates) but its deque was full, or it was forwarded by another TSU thread
+	if (iqEntry.type == IQ_READY_INSTANCE) {
+		scheduleDThread(shard, iqEntry.tid, iqEntry.context, threadTemplate, iqEntry.data, producer);
+		return;
+	}
 
-			//cout << "Multiple Update for DThread " << threadTemplate->tid << ": " << entireContextToString(iqEntry.context, threadTemplate->nesting)
-			//		<< " to " << entireContextToString(iqEntry.maxContext, threadTemplate->nesting) << endl;
+	// If the RC=1 then update without using any SM
+	isFastExecute = (threadTemplate->readyCount == 1);
 
-			// TODO: check if the context > maxContext. isMultUpdateValid is wrong at the moment
-			/*
-			 // Check if the context has larger parts than maxContext
-			 if (!isMultUpdateValid(iqEntry.context, iqEntry.maxContext, threadTemplate->nesting)) {
-			 PRINT_INVALID_MULT_CONTEXTS(threadTemplate, iqEntry.context, iqEntry.maxContext);
-			 exit(ERROR);
-			 }*/
+	///////////// Update the DThreads /////////////
+	synchMemory = threadTemplate->SM;  // Get the Static SM of a DThread if exists
 
-			if (isFastExecute) {
-				scheduleMultipleContexts(iqEntry.tid, iqEntry.context, iqEntry.maxContext, threadTemplate);
-			}
-			else {
-				// Check if the Contexts are valid in the case of DThread's RC != 1
-				if (synchMemory && (!synchMemory->isContextValid(iqEntry.context) || !synchMemory->isContextValid(iqEntry.maxContext))) {
-					cout << "Error while updating DThread " << iqEntry.tid << " Invalid Contexts: from "
-					    << Auxiliary::entireContextToString(iqEntry.context, threadTemplate->nesting) << " to "
-					    << Auxiliary::entireContextToString(iqEntry.maxContext, threadTemplate->nesting) << endl;
-					exit(ERROR);
-				}
-
-				updateMultipleContexts(iqEntry.tid, iqEntry.context, iqEntry.maxContext, threadTemplate);
-			}
+	// For multiple updates. The DThreads with RC=1 are scheduled immediately.
+	if (iqEntry.type == IQ_MULTIPLE_UPDATE) {
+
+		//cout << "Multiple Update for DThread " << threadTemplate->tid << ": " << entireContextToString(iqEntry.context, threadTemplate->nesting)
+		//		<< " to " << entireContextToString(iqEntry.maxContext, threadTemplate->nesting) << endl;
+
+		// TODO: check if the context > maxContext. isMultUpdateValid is wrong at the moment
+		/*
+		 // Check if the context has larger parts than maxContext
+		 if (!isMultUpdateValid(iqEntry.context, iqEntry.maxContext, threadTemplate->nesting)) {
+		 PRINT_INVALID_MULT_CONTEXTS(threadTemplate, iqEntry.context, iqEntry.maxContext);
+		 exit(ERROR);
+		 }*/
+
+		if (isFastExecute) {
+			scheduleMultipleContexts(shard, iqEntry.tid, iqEntry.context, iqEntry.maxContext, threadTemplate, producer);
 		}
 		else {
-			//cout << "Single Update for DThread " << threadTemplate->tid << ": " << entireContextToString(iqEntry.context, threadTemplate->nesting) << endl;
-
-			// For single updates. The DThreads with RC=1 are scheduled immediately
-			if (isFastExecute) {
-				scheduleDThread(iqEntry.tid, iqEntry.context, threadTemplate, iqEntry.data);
+			// Check if the Contexts are valid in the case of DThread's RC != 1
+			if (synchMemory && !synchMemory->isRangeValid(iqEntry.context, iqEntry.maxContext)) {
+				cout << "Error while updating DThread " << iqEntry.tid << " Invalid Contexts: from "
+				    << Auxiliary::entireContextToString(iqEntry.context, threadTemplate->nesting) << " to "
+				    << Auxiliary::entireContextToString(iqEntry.maxContext, threadTemplate->nesting) << endl;
+				exit(ERROR);
 			}
-			else {
-				// Check if the Context is valid
-				if (synchMemory && !synchMemory->isContextValid(iqEntry.context)) {
 
-					cout << "Error while updating DThread " << iqEntry.tid << " Invalid Context: "
-					    << Auxiliary::entireContextToString(iqEntry.context, threadTemplate->nesting) << endl;
+			updateMultipleContexts(shard, iqEntry.tid, iqEntry.context, iqEntry.maxContext, threadTemplate, producer);
+		}
+	}
+	else {
+		//cout << "Single Update for DThread " << threadTemplate->tid << ": " << entireContextToString(iqEntry.context, threadTemplate->nesting) << endl;
+
+		// For single updates. The DThreads with RC=1 are scheduled immediately
+		if (isFastExecute) {
+			scheduleDThread(shard, iqEntry.tid, iqEntry.context, threadTemplate, iqEntry.data, producer);
+		}
+		else {
+			// Check if the Context is valid
+			if (synchMemory && !synchMemory->isContextValid(iqEntry.context)) {
 
-					exit(ERROR);
-				}
+				cout << "Error while updating DThread " << iqEntry.tid << " Invalid Context: "
+				    << Auxiliary::entireContextToString(iqEntry.context, threadTemplate->nesting) << endl;
 
-				updateSingleContext(iqEntry.tid, iqEntry.context, threadTemplate, iqEntry.data);
+				exit(ERROR);
 			}
+
+			updateSingleContext(shard, iqEntry.tid, iqEntry.context, threadTemplate, iqEntry.data, producer);
 		}
-	}  // End of While
+	}
 }
 
 /**
  * Updates multiple contexts of the same DThread. The updateSingleContext method is used.
+ * @param[in] shard the TSU thread that executes the update
  * @param tid the Thread ID
  * @param context[in] the start of the Context
  * @param maxContext[in] the end of the Context
  * @param[in] threadTemplate threadTemplate the Thread Template of the DThread that is going to be updated
+ * @param[in] producer the ID of the Kernel that sent the update
  */
-void TSU::updateMultipleContexts(TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate) {
+void TSU::updateMultipleContexts(TSUShard& shard, TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate, KernelID producer) {
 
 	switch (threadTemplate->nesting) {
 		// We put the code here in order to increase performance
 		case Nesting::ONE:
 			for (cntx_1D_t cntxInn = GET_N1(context); cntxInn < (GET_N1(maxContext) + 1); ++cntxInn)
-				updateSingleContext(tid, CREATE_N1(cntxInn), threadTemplate, nullptr);
+				updateSingleContext(shard, tid, CREATE_N1(cntxInn), threadTemplate, nullptr, producer);
 			break;
 
 		case Nesting::TWO:
 			for (cntx_2D_Out_t cntxOut = GET_N2_OUTER(context); cntxOut < (GET_N2_OUTER(maxContext) + 1U); ++cntxOut)
 				for (cntx_2D_In_t cntxInn = GET_N2_INNER(context); cntxInn < (GET_N2_INNER(maxContext) + 1U); ++cntxInn)
-					updateSingleContext(tid, CREATE_N2(cntxOut, cntxInn), threadTemplate, nullptr);
+					updateSingleContext(shard, tid, CREATE_N2(cntxOut, cntxInn), threadTemplate, nullptr, producer);
 			break;
 
 		case Nesting::THREE:
 			for (cntx_3D_Out_t cntxOut = GET_N3_OUTER(context); cntxOut < (GET_N3_OUTER(maxContext) + 1U); ++cntxOut)
 				for (cntx_3D_Mid_t cntxMid = GET_N3_MIDDLE(context); cntxMid < (GET_N3_MIDDLE(maxContext) + 1U); ++cntxMid)
 					for (cntx_3D_In_t cntxInn = GET_N3_INNER(context); cntxInn < (GET_N3_INNER(maxContext) + 1U); ++cntxInn)
-						updateSingleContext(tid, CREATE_N3(cntxOut, cntxMid, cntxInn), threadTemplate, nullptr);
+						updateSingleContext(shard, tid, CREATE_N3(cntxOut, cntxMid, cntxInn), threadTemplate, nullptr, producer);
 			break;
 
 		default:
@@ -328,31 +558,39 @@ void TSU::updateMultipleContexts(TID tid, const context_t& context, const contex
 
 /**
  * Schedules multiple instances of the same DThread immediately
+ * @param[in] shard the TSU thread that executes the update
  * @param[in] tid the Thread ID
  * @param[in] context the start of the Context
  * @param[in] maxContext the end of the Context
  * @param[in] threadTemplate threadTemplate the Thread Template of the DThread that is going to be updated
+ * @param[in] producer the ID of the Kernel that sent the update
  */
-void TSU::scheduleMultipleContexts(TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate) {
+void TSU::scheduleMultipleContexts(TSUShard& shard, TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate, KernelID producer) {
+
+	// The instances are not mapped to specific Kernels. Schedule the whole range and let the Kernels split it.
+	if (isRangeSchedulable(threadTemplate)) {
+		scheduleRange(shard, tid, context, maxContext, threadTemplate, m_workStealing ? 1 : shard.ownedKernels);
+		return;
+	}
 
 	switch (threadTemplate->nesting) {
 		// We put the code here in order to increase performance
 		case Nesting::ONE:
 			for (cntx_1D_t cntxInn = GET_N1(context); cntxInn < (GET_N1(maxContext) + 1U); ++cntxInn)
-				scheduleDThread(tid, CREATE_N1(cntxInn), threadTemplate, nullptr);
+				scheduleDThread(shard, tid, CREATE_N1(cntxInn), threadTemplate, nullptr, producer);
 			break;
 
 		case Nesting::TWO:
 			for (cntx_2D_Out_t cntxOut = GET_N2_OUTER(context); cntxOut < (GET_N2_OUTER(maxContext) + 1U); ++cntxOut)
 				for (cntx_2D_In_t cntxInn = GET_N2_INNER(context); cntxInn < (GET_N2_INNER(maxContext) + 1U); ++cntxInn)
-					scheduleDThread(tid, CREATE_N2(cntxOut, cntxInn), threadTemplate, nullptr);
+					scheduleDThread(shard, tid, CREATE_N2(cntxOut, cntxInn), threadTemplate, nullptr, producer);
 			break;
 
 		case Nesting::THREE:
 			for (cntx_3D_Out_t cntxOut = GET_N3_OUTER(context); cntxOut < (GET_N3_OUTER(maxContext) + 1U); ++cntxOut)
 				for (cntx_3D_Mid_t cntxMid = GET_N3_MIDDLE(context); cntxMid < (GET_N3_MIDDLE(maxContext) + 1U); ++cntxMid)
 					for (cntx_3D_In_t cntxInn = GET_N3_INNER(context); cntxInn < (GET_N3_INNER(maxContext) + 1U); ++cntxInn)
-						scheduleDThread(tid, CREATE_N3(cntxOut, cntxMid, cntxInn), threadTemplate, nullptr);
+						scheduleDThread(shard, tid, CREATE_N3(cntxOut, cntxMid, cntxInn), threadTemplate, nullptr, producer);
 			break;
 
 		default:
@@ -361,69 +599,361 @@ void TSU::scheduleMultipleContexts(TID tid, const context_t& context, const cont
 	}
 }
 
+/**
+ * Schedules a range of ready instances of the same DThread as a single OQ entry
+ * @param[in] shard the TSU thread that executes the update
+ * @param[in] tid the Thread ID
+ * @param[in] context the start of the Context
+ * @param[in] maxContext the end of the Context
+ * @param[in] threadTemplate the Thread Template of the DThread
+ * @param[in] pieces the number of pieces in which the range is split before it is scheduled
+ * @note with the work-stealing the range is scheduled in one piece, since the idle Kernels steal halves of it.
+ * Otherwise, it is split in one piece per Kernel of the TSU thread.
+ */
+void TSU::scheduleRange(TSUShard& shard, TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate, UInt pieces) {
+	OQ_Entry range, upper;
+	range.nesting = threadTemplate->nesting;
+	range.context = context;
+	range.maxContext = maxContext;
+
+	if (pieces > 1 && Kernel::splitRange(&range, &upper)) {
+		scheduleRange(shard, tid, range.context, range.maxContext, threadTemplate, pieces / 2);
+		scheduleRange(shard, tid, upper.context, upper.maxContext, threadTemplate, pieces - pieces / 2);
+		return;
+	}
+
+	range.ifp = threadTemplate->ifp;
+	range.isRange = true;
+
+	placeReadyEntry(shard, range, DEFAULT_PRIORITY, NO_KERNEL_ID);
+}
+
 /**
  * Used to schedule a DThread in the appropriate Kernel
+ * @param[in] shard the TSU thread that made the DThread ready
  * @param tid the Thread ID of the scheduled DThread
  * @param context the context of the scheduled DThread
  * @param threadTemplate the Thread Template of the DThread that is going to be updated
  * @param data the data of the DThread
+ * @param producer the ID of the Kernel that made the DThread ready or NO_KERNEL_ID if it is unknown
  */
-void TSU::scheduleDThread(TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data) {
-	register KernelID selectedKernel = 0;
+void TSU::scheduleDThread(TSUShard& shard, TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data, KernelID producer) {
+	UInt priority = getPriority(threadTemplate, context);
+	KernelID selectedKernel = getTargetKernel(threadTemplate, context);
+	OQ_Entry entry;
+
+	// Only the owner of the selected Kernel inserts ready DThreads in its Output Queues
+	if (selectedKernel != NO_KERNEL_ID && !shard.ownsKernel(selectedKernel)) {
+		forwardReadyInstance(shard, selectedKernel, tid, context, data);
+		return;
+	}
 
-	// Assign the ready DThread to the Kernel with the least amount of work -> We are trying to balance the loading of ready DThreads in the cores
-	int curOutputQueueSize, leastWork;
-	UInt m_leastWorkKenelID;  // Indicates the ID of the Kernel with the least amount of work
+	entry.ifp = threadTemplate->ifp;
+	entry.context = context;
+	entry.nesting = threadTemplate->nesting;
+	entry.data = data;
+	entry.isRange = false;
 
-	// Find the Kernel with the least amount of work. If the insertion in the Output Queue failed, try again.
-	do {
-		// Assume that Kernel 0 has the least amount of work
-		leastWork = m_kernels[0]->getOutputQueueSize();
-		m_leastWorkKenelID = 0;
+	// Keep the instance in the Kernel that made it ready, as long as the Kernel is not overloaded and the TSU thread owns it.
+	// With the work-stealing it is pinned, otherwise the next transfer of the Output Queue would make it available to the thieves.
+	if (selectedKernel == NO_KERNEL_ID && priority == DEFAULT_PRIORITY && threadTemplate->schedMethod == SchedulingMethod::PRODUCER_AFFINE
+	    && producer != NO_KERNEL_ID && shard.ownsKernel(producer) && m_kernels[producer]->getQueuedDThreads() < threadTemplate->schedValue) {
+		entry.isPinned = m_workStealing;
 
-		// Check the other Kernels, to find the Kernel with the least amount of work
-		for (UInt i = 1; i < m_kernelsNum; ++i) {
-			curOutputQueueSize = m_kernels[i]->getOutputQueueSize();
+		if (tryAddReadyEntry(shard, producer, entry, priority))
+			return;
 
-			if (curOutputQueueSize < leastWork) {
-				leastWork = curOutputQueueSize;
-				m_leastWorkKenelID = i;
-			}
+		entry.isPinned = false;
+	}
+
+	placeReadyEntry(shard, entry, priority, selectedKernel);
+}
+
+/**
+ * Inserts a ready instance (or range) in the Output Queue of a Kernel. If the Output Queues are full, the instance is stored in the
+ * Ready Backlog of a Kernel and the TSU continues with the updates.
+ * @param[in] shard the TSU thread that inserts the instance
+ * @param[in] entry the ready instance
+ * @param[in] priority the priority of the instance
+ * @param[in] selectedKernel the Kernel that the Scheduling Policy maps the instance to or NO_KERNEL_ID if the instance is not mapped.
+ * The Kernel has to be owned by the TSU thread.
+ */
+void TSU::placeReadyEntry(TSUShard& shard, const OQ_Entry& entry, UInt priority, KernelID selectedKernel) {
+	// The Scheduling Policy maps the instance to a specific Kernel. With the work-stealing it is pinned, i.e. it is kept out of the
+	// Kernel's Work-Stealing Deque, otherwise an idle Kernel could steal it.
+	if (selectedKernel != NO_KERNEL_ID) {
+		OQ_Entry mapped = entry;
+		mapped.isPinned = m_workStealing && priority == DEFAULT_PRIORITY;
+
+		if (!tryAddReadyEntry(shard, selectedKernel, mapped, priority))
+			addInReadyBacklog(shard, selectedKernel, mapped, priority);
+
+		return;
+	}
+
+	// The Kernels balance the load by themselves. Place the ready DThread in the next Kernel whose Output Queue is not full.
+	// The priority instances are not stolen, thus they are spread over the Kernels in the same round-robin fashion.
+	// Each TSU thread visits only its own Kernels.
+	if (m_workStealing) {
+		for (UInt i = 0; i < shard.ownedKernels; ++i) {
+			selectedKernel = shard.nextKernel;
+			shard.nextKernel = (shard.nextKernel + m_shardsNum >= m_kernelsNum) ? shard.id : shard.nextKernel + m_shardsNum;
+
+			if (tryAddReadyEntry(shard, selectedKernel, entry, priority))
+				return;
 		}
 
-		selectedKernel = m_leastWorkKenelID;
+		addInReadyBacklog(shard, selectedKernel, entry, priority);
+		return;
 	}
-	while (!m_kernels[selectedKernel]->addReadyDThread(threadTemplate->ifp, tid, context, threadTemplate->nesting, data));
 
+	// Assign the ready DThread to the Kernel with the least amount of work -> We are trying to balance the loading of ready DThreads in the cores.
+	// If its Output Queue is full, all the Output Queues of the TSU thread are full.
+	selectedKernel = getLeastLoadedKernel(shard);
+
+	if (!tryAddReadyEntry(shard, selectedKernel, entry, priority))
+		addInReadyBacklog(shard, selectedKernel, entry, priority);
+}
+
+/**
+ * Moves the ready instances of the Ready Backlogs of a TSU thread in the Output Queues of their Kernels, as long as the Output Queues
+ * have free space
+ * @param[in] shard the TSU thread
+ * @return true if at least one instance is moved
+ */
+bool TSU::drainReadyBacklogs(TSUShard& shard) {
+	bool isMoved = false;
+
+	for (UInt i = shard.id; i < m_kernelsNum; i += m_shardsNum) {
+		ReadyBacklog& backlog = *shard.readyBacklogs[i];
+
+		while (!backlog.empty() && m_kernels[i]->addReadyEntry(backlog.front().entry, backlog.front().priority)) {
+			backlog.pop();
+			shard.readyBacklogSize--;
+			isMoved = true;
+		}
+	}
+
+	return isMoved;
 }
 
 /**
  * Updates a single Ready Count. If the Ready Count is equal to zero, it inserts the ready DThread in the appropriate Output Queue
+ * @param[in] shard the TSU thread that executes the update
  * @param[in] tid the Thread ID
  * @param[in] context the context of the scheduled DThread
  * @param[in] threadTemplate the Thread Template of the DThread that is going to be updated
  * @param[in] data the data of the DThread
+ * @param[in] producer the ID of the Kernel that sent the update
  * @note this function is used when a DThread has RC > 1 and Nesting != 0. Also, we have to check if the Contexts are valid, in the case we are
  * using the Static SM.
  */
-void TSU::updateSingleContext(TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data) {
+void TSU::updateSingleContext(TSUShard& shard, TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data, KernelID producer) {
 	// Select the appropriate SM.
 	StaticSM* synchMemory = threadTemplate->SM;
 
+	// The Kernels may update the same SMs concurrently
+	if (m_decentralizedUpdates) {
+		if (synchMemory ? synchMemory->atomicUpdate(context) : threadTemplate->dynamicSM->concurrentUpdate(context))
+			scheduleDThread(shard, tid, context, threadTemplate, data, producer);
+
+		return;
+	}
+
 	// If the static SM is not null use it, otherwise use the dynamic SM
 	if (synchMemory) {
-		// Get the RC value of the DThread's instance
-		ReadyCount prevRC = synchMemory->getReadyCount(context);
+		if (synchMemory->update(context))
+			scheduleDThread(shard, tid, context, threadTemplate, data, producer);
+	}
+	else {
+		if (threadTemplate->dynamicSM->update(context))
+			scheduleDThread(shard, tid, context, threadTemplate, data, producer);
+	}
+}
 
-		if (prevRC == 1)  // This means that after the update the DThread will be ready for execution
-			scheduleDThread(tid, context, threadTemplate, data);
+/**
+ * Decrements the Ready Count of a DThread's instance by the calling Kernel (decentralized updates).
+ * If the instance becomes ready it is inserted in the Kernel's Work-Stealing Deque.
+ * @param[in] kernelID the ID of the calling Kernel
+ * @param[in] tid the Thread ID
+ * @param[in] context the context of the instance
+ * @param[in] data the data of the DThread
+ */
+void TSU::applyLocalUpdate(KernelID kernelID, TID tid, const context_t& context, void* data) {
+	ThreadTemplate* threadTemplate = m_TemplateMemory.getTemplate(tid);
 
-		// Update the DThread with this Context
-		synchMemory->update(context);
+	if (!threadTemplate) {
+		printf("Error while updating => The DThread with id: %d does not exists.\n", tid);
+		exit(ERROR);
+	}
+
+	// The DThreads with RC=1 are ready immediately
+	if (threadTemplate->readyCount == 1) {
+		scheduleLocally(kernelID, tid, context, threadTemplate, data);
+		return;
+	}
+
+	StaticSM* synchMemory = threadTemplate->SM;
+
+	if (synchMemory) {
+		if (!synchMemory->isContextValid(context)) {
+			cout << "Error while updating DThread " << tid << " Invalid Context: " << Auxiliary::entireContextToString(context, threadTemplate->nesting)
+			    << endl;
+			exit(ERROR);
+		}
+
+		if (synchMemory->atomicUpdate(context))
+			scheduleLocally(kernelID, tid, context, threadTemplate, data);
+	}
+	else if (threadTemplate->dynamicSM->concurrentUpdate(context)) {
+		scheduleLocally(kernelID, tid, context, threadTemplate, data);
+	}
+}
+
+/**
+ * Decrements the Ready Counts of multiple instances of a DThread by the calling Kernel (decentralized updates)
+ * @param[in] kernelID the ID of the calling Kernel
+ * @param[in] tid the Thread ID
+ * @param[in] context the start of the Context
+ * @param[in] maxContext the end of the Context
+ */
+void TSU::applyLocalMultipleUpdate(KernelID kernelID, TID tid, const context_t& context, const context_t& maxContext) {
+	ThreadTemplate* threadTemplate = m_TemplateMemory.getTemplate(tid);
+
+	if (!threadTemplate) {
+		printf("Error while updating => The DThread with id: %d does not exists.\n", tid);
+		exit(ERROR);
+	}
+
+	// The DThreads with RC=1 are ready immediately
+	if (threadTemplate->readyCount == 1) {
+		scheduleRangeLocally(kernelID, tid, context, maxContext, threadTemplate);
+		return;
+	}
+
+	StaticSM* synchMemory = threadTemplate->SM;
+
+	if (synchMemory) {
+		if (!synchMemory->isRangeValid(context, maxContext)) {
+			cout << "Error while updating DThread " << tid << " Invalid Contexts: from " << Auxiliary::entireContextToString(context, threadTemplate->nesting)
+			    << " to " << Auxiliary::entireContextToString(maxContext, threadTemplate->nesting) << endl;
+			exit(ERROR);
+		}
+
+		forEachContext(threadTemplate->nesting, context, maxContext, [&](const context_t& cntx) {
+			if (synchMemory->atomicUpdate(cntx))
+				scheduleLocally(kernelID, tid, cntx, threadTemplate, nullptr);
+		});
 	}
 	else {
-		if (threadTemplate->dynamicSM->update(context))
-			scheduleDThread(tid, context, threadTemplate, data);
+		forEachContext(threadTemplate->nesting, context, maxContext, [&](const context_t& cntx) {
+			if (threadTemplate->dynamicSM->concurrentUpdate(cntx))
+				scheduleLocally(kernelID, tid, cntx, threadTemplate, nullptr);
+		});
+	}
+}
+
+/**
+ * Inserts the instances of a DThread with Ready Count 1 in the calling Kernel's Work-Stealing Deque. If their instances are not
+ * mapped to specific Kernels, the whole range is inserted as a single entry.
+ * @param[in] kernelID the ID of the calling Kernel
+ * @param[in] tid the Thread ID
+ * @param[in] context the start of the Context
+ * @param[in] maxContext the end of the Context
+ * @param[in] threadTemplate the Thread Template of the DThread
+ */
+void TSU::scheduleRangeLocally(KernelID kernelID, TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate) {
+	if (isRangeSchedulable(threadTemplate) && m_kernels[kernelID]->addLocalReadyRange(threadTemplate->ifp, context, maxContext, threadTemplate->nesting))
+		return;
+
+	forEachContext(threadTemplate->nesting, context, maxContext, [&](const context_t& cntx) {
+		scheduleLocally(kernelID, tid, cntx, threadTemplate, nullptr);
+	});
+}
+
+/**
+ * Inserts an instance that became ready by the calling Kernel in the Kernel's Work-Stealing Deque or executes it inline, if the
+ * inline execution depth allows it. If the deque is full the instance is forwarded to the TSU through the Kernel's Input Queue.
+ * With the work-stealing, the instances that are mapped to the calling Kernel and the PRODUCER_AFFINE instances (while the Kernel is
+ * not overloaded) are only executed inline, since the other Kernels may steal them from the deque.
+ * @param[in] kernelID the ID of the calling Kernel
+ * @param[in] tid the Thread ID
+ * @param[in] context the context of the ready instance
+ * @param[in] threadTemplate the Thread Template of the DThread
+ * @param[in] data the data of the DThread
+ */
+void TSU::scheduleLocally(KernelID kernelID, TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data) {
+	KernelID targetKernel = getTargetKernel(threadTemplate, context);
+
+	if ((targetKernel == NO_KERNEL_ID || targetKernel == kernelID) && getPriority(threadTemplate, context) == DEFAULT_PRIORITY) {
+		Kernel* kernel = m_kernels[kernelID];
+		bool isPinned = m_workStealing
+		    && (targetKernel != NO_KERNEL_ID
+		        || (threadTemplate->schedMethod == SchedulingMethod::PRODUCER_AFFINE && kernel->getQueuedDThreads() < threadTemplate->schedValue));
+
+		if (kernel->executeInline(threadTemplate->ifp, context, threadTemplate->nesting, data)
+		    || (!isPinned && kernel->addLocalReadyDThread(threadTemplate->ifp, context, threadTemplate->nesting, data)))
+			return;
+	}
+
+	// The instance belongs to another Kernel, it is pinned, it has a priority or the deque is full. Let the TSU schedule the instance.
+	TSUShard& shard = getOwnerShard(tid);
+
+	if (!shard.inputQueues[kernelID]->enqueueReady(tid, context, data)) {
+		IQ_Entry iqEntry;
+		iqEntry.tid = tid;
+		iqEntry.context = context;
+		iqEntry.type = IQ_READY_INSTANCE;
+		iqEntry.data = data;
+		spillUpdate(shard, kernelID, iqEntry);
+	}
+
+	notifyUpdates(shard, kernelID);
+}
+
+/**
+ * Called when the spill memory budget is exhausted. The calling Kernel executes ready DThreads or waits until the update
+ * fits in its Input Queue or in its Unlimited Input Queue. If waiting makes no progress the budget is exceeded, i.e. it is a
+ * soft limit. The exceeding updates are counted in the forcedSpills of the Kernel's SpillStatistics.
+ * @param[in] shard the TSU thread that receives the update
+ * @param[in] kernelID the ID of the Kernel that sends the update
+ * @param[in] iqEntry the update
+ */
+void TSU::applyBackpressure(TSUShard& shard, KernelID kernelID, const IQ_Entry& iqEntry) {
+	UnlimitedInputQueue* uiq = shard.unlimitedIQs[kernelID];
+	Kernel* kernel = m_kernels[kernelID];
+	SpillStatistics& stats = uiq->getStatistics();
+	UInt idleIterations = 0;
+
+	// Only a running Kernel waits for the TSU. The other threads (e.g. the main thread before the run() function) exceed the budget.
+	if (!kernel->isCurrentThread()) {
+		uiq->enqueue(iqEntry);
+		stats.forcedSpills++;
+		return;
+	}
+
+	stats.throttledUpdates++;
+
+	while (true) {
+		if (m_idlePolicy.parkingEnabled)
+			shard.doorbell.ring();  // The TSU thread has to drain the Input Queue, even if it is parked
+
+		if (shard.inputQueues[kernelID]->enqueue(iqEntry) || uiq->tryEnqueue(iqEntry))
+			return;
+
+		// Help by executing ready DThreads. This also frees space in the Output Queues, in which the TSU may wait to schedule.
+		if (kernel->executeReadyDThread()) {
+			stats.executedDThreads++;
+			idleIterations = 0;
+		}
+		else if (++idleIterations < SPILL_THROTTLE_LIMIT) {
+			sched_yield();
+		}
+		else {
+			uiq->enqueue(iqEntry);
+			stats.forcedSpills++;
+			return;
+		}
 	}
 }
 
@@ -452,6 +982,8 @@ void TSU::storePendingThreadTemplates() {
 	}
 
 	// Store the pending Thread Templates in the TSU
+	ThreadTemplate* threadTemplate;
+
 	for (auto& pendT : m_pendingTTs) {
 		// If an RC of a DThread is <= 0 set to 1 since the DThread has no consumers
 		if (pendT.second.readyCount <= 0)
@@ -459,27 +991,30 @@ void TSU::storePendingThreadTemplates() {
 
 		// Store the Thread Template
 		if (pendT.second.isStatic) {
+			threadTemplate = m_TemplateMemory.addTemplate(pendT.second.ifp, pendT.first, pendT.second.nesting, pendT.second.readyCount,
+			    pendT.second.innerRange, pendT.second.middleRange, pendT.second.outerRange, pendT.second.smType);
 
-			LOCK_TT();
-
-			if (!m_TemplateMemory.addTemplate(pendT.second.ifp, pendT.first, pendT.second.nesting, pendT.second.readyCount, pendT.second.innerRange,
-			    pendT.second.middleRange, pendT.second.outerRange)) {
-				printf("Error while inserting a DThread => The Template Memory is full.\n");
+			if (!threadTemplate) {
+				printf("Error while inserting a DThread => The tid:%d is already used for another DThread.\n", pendT.first);
 				exit(ERROR);
 			}
-
-			UNLOCK_TT();
 		}
 		else {
-			LOCK_TT();
+			threadTemplate = m_TemplateMemory.addTemplate(pendT.second.ifp, pendT.first, pendT.second.nesting, pendT.second.readyCount,
+			    pendT.second.smType);
 
-			if (!m_TemplateMemory.addTemplate(pendT.second.ifp, pendT.first, pendT.second.nesting, pendT.second.readyCount)) {
-				printf("Error while inserting a DThread => The Template Memory is full.\n");
+			if (!threadTemplate) {
+				printf("Error while inserting a DThread => The tid:%d is already used for another DThread.\n", pendT.first);
 				exit(ERROR);
 			}
-
-			UNLOCK_TT();
 		}
+
+		// Keep the Scheduling Policy and the Priority that were set before the RC calculation
+		threadTemplate->schedMethod = pendT.second.schedMethod;
+		threadTemplate->schedValue = pendT.second.schedValue;
+		threadTemplate->schedFunction = pendT.second.schedFunction;
+		threadTemplate->priority = pendT.second.priority;
+		threadTemplate->priorityFunction = pendT.second.priorityFunction;
 	}
 
 	m_pendingTTs.clear();  // Clear the Pending DThreads
@@ -34,9 +34,14 @@
 #include "PendingThreadTemplate.h"
 #include "TemplateMemory.h"
 #include "InputQueue.h"
+#include "UnlimitedInputQueue.h"
+#include "PendingWorkMap.h"
+#include "TSUShard.h"
 #include "Kernel.h"
+#include "Doorbell.h"
 #include "GraphMemory.h"
-#include <queue>
+#include <atomic>
+#include <algorithm>
 
 // Definitions
 #define PROTECT_TT 			 // Protect the Thread Templates, i.e. allocating/deallocating thread templates are thread-safe operations
@@ -111,24 +116,32 @@ class TSU
 		 */
 		inline void runSingleNode(void) {
 			// Local Variables
-			UInt i;
+			TSUShard& shard = *m_shards[0];  // The calling thread runs the first shard and it detects the termination
 			bool isFinished;
+			IdleBackoff backoff;
+
+			// The other TSU threads apply the updates of their DThreads until the execution is finished
+			startShards();
 
 			// Update the DThreads until there is no data in any TSU's queue (Input and Output Queues)
 			do {
-				isFinished = true;
-
 				// Executes updates until something is wrong (for example, when the Input Queues are full)
-				getUpdatesAndExecute();
+				if (getUpdatesAndExecute(shard))
+					backoff.reset();
 
-				for (i = 0; i < m_kernelsNum; ++i) {
-					if (!m_kernels[i]->isOutputQueueEmpty() || !m_InputQueues[i]->isEmpty() || !m_UnlimitedIQs[i]->empty()) {
-						isFinished = false;
-						break;
-					}
-				}
+				// Move the ready instances that did not fit in the Output Queues
+				if (shard.readyBacklogSize != 0 && drainReadyBacklogs(shard))
+					backoff.reset();
+
+				isFinished = !hasPendingWork();
+
+				// Wait for new updates or for the Kernels and the other TSU threads to finish their work
+				if (!isFinished)
+					backoff.idle(m_idlePolicy, shard.doorbell, [&]() {return hasUpdates(shard) || canDrainReadyBacklogs(shard) || (areKernelsIdle() && areShardsIdle());});
 			}
 			while (!isFinished);
+
+			stopShards();
 		}
 
 		/**
@@ -139,9 +152,12 @@ class TSU
 		 * @param[in] innerRange the range of the inner Context
 		 * @param[in] middleRange the range of the middle Context
 		 * @param[in] outerRange the range of the outer Context
+		 * @param[in] smType the storage of the DThread's SM. By default a Static SM is used.
+		 * @param[in] domain the domain of the Contexts or nullptr if all the Contexts of the ranges are valid. It requires a Static SM.
 		 * @return the TID of the created DThread
 		 */
-		inline TID addDThread(IFP ifp, Nesting nesting, ReadyCount readyCount, UInt innerRange, UInt middleRange, UInt outerRange) {
+		inline TID addDThread(IFP ifp, Nesting nesting, ReadyCount readyCount, UInt innerRange, UInt middleRange, UInt outerRange,
+		    SMType smType = SMType::AUTO_SM, const ContextDomain* domain = nullptr) {
 
 			if (readyCount <= 0) {
 				printf("Error while inserting a DThread => The readyCount has to be greater that zero.\n");
@@ -153,29 +169,20 @@ class TSU
 				exit(ERROR);
 			}
 
-			LOCK_TT();
-
-			TID tid = m_tidCounter;
-			m_tidCounter++;  // Increase the counter of the DThread IDs
-
-			if (tid <= 0) {
-				printf("Error while inserting a DThread => The tid has to be greater that zero.\n");
+			if (domain && smType != SMType::AUTO_SM && smType != SMType::DENSE_SM) {
+				printf("Error while inserting a DThread => The domain of the Contexts requires the DENSE_SM storage.\n");
 				exit(ERROR);
 			}
 
-			if (m_TemplateMemory.contains(tid)) {
-				printf("Error while inserting a DThread => the tid:%d is already used for another DThread.\n", tid);
-				exit(ERROR);
-			}
+			// The Template Memory is thread-safe, i.e. multiple threads can insert DThreads concurrently
+			TID tid = allocateTID();
 
 			// Store the Thread Template
-			if (!m_TemplateMemory.addTemplate(ifp, tid, nesting, readyCount, innerRange, middleRange, outerRange)) {
-				printf("Error while inserting a DThread => The Template Memory is full.\n");
+			if (!m_TemplateMemory.addTemplate(ifp, tid, nesting, readyCount, innerRange, middleRange, outerRange, smType, domain)) {
+				printf("Error while inserting a DThread => The tid:%d is already used for another DThread.\n", tid);
 				exit(ERROR);
 			}
 
-			UNLOCK_TT();
-
 			return tid;
 		}
 
@@ -184,37 +191,31 @@ class TSU
 		 * @param[in] ifp the pointer of the DThread's function
 		 * @param[in] nesting	the Dthread's nesting
 		 * @param[in] readyCount the Dthread's Ready Count, i.e. the number of its producer-threads
+		 * @param[in] smType the storage of the DThread's Dynamic SM. DENSE_SM is not allowed, since the ranges of the Contexts are unknown.
+		 * @param[in] initialCapacity the initial number of slots of the HASH_SM storage
 		 * @return the TID of the created DThread
 		 */
-		inline TID addDThread(IFP ifp, Nesting nesting, ReadyCount readyCount) {
+		inline TID addDThread(IFP ifp, Nesting nesting, ReadyCount readyCount, SMType smType = SMType::AUTO_SM,
+		    size_t initialCapacity = DYNAMIC_SM_INITIAL_CAPACITY) {
 			if (readyCount <= 0) {
 				printf("Error while inserting a DThread => The readyCount has to be greater that zero.\n");
 				exit(ERROR);
 			}
 
-			LOCK_TT();
-
-			TID tid = m_tidCounter;
-			m_tidCounter++;  // Increase the counter of the DThread IDs
-
-			if (tid <= 0) {
-				printf("Error while inserting a DThread => The tid has to be greater that zero.\n");
+			if (smType == SMType::DENSE_SM && nesting != Nesting::ZERO) {
+				printf("Error while inserting a DThread => The DENSE_SM storage requires the ranges of the Contexts.\n");
 				exit(ERROR);
 			}
 
-			if (m_TemplateMemory.contains(tid)) {
-				printf("Error while inserting a DThread => the tid:%d is already used for another DThread.\n", tid);
-				exit(ERROR);
-			}
+			// The Template Memory is thread-safe, i.e. multiple threads can insert DThreads concurrently
+			TID tid = allocateTID();
 
 			// Store the Thread Template
-			if (!m_TemplateMemory.addTemplate(ifp, tid, nesting, readyCount)) {
-				printf("Error while inserting a DThread => The Template Memory is full.\n");
+			if (!m_TemplateMemory.addTemplate(ifp, tid, nesting, readyCount, smType, initialCapacity)) {
+				printf("Error while inserting a DThread => The tid:%d is already used for another DThread.\n", tid);
 				exit(ERROR);
 			}
 
-			UNLOCK_TT();
-
 			return tid;
 		}
 
@@ -225,9 +226,10 @@ class TSU
 		 * @param[in] innerRange the range of the inner Context
 		 * @param[in] middleRange the range of the middle Context
 		 * @param[in] outerRange the range of the outer Context
+		 * @param[in] smType the storage of the DThread's SM. By default a Static SM is used.
 		 * @return the TID of the created DThread
 		 */
-		inline TID addDThread(IFP ifp, Nesting nesting, UInt innerRange, UInt middleRange, UInt outerRange) {
+		inline TID addDThread(IFP ifp, Nesting nesting, UInt innerRange, UInt middleRange, UInt outerRange, SMType smType = SMType::AUTO_SM) {
 
 			if (innerRange <= 0 || middleRange <= 0 || outerRange <= 0) {
 				printf("Error while inserting a DThread => The ranges of the Contexts have to be greater that zero.\n");
@@ -243,21 +245,11 @@ class TSU
 			p.middleRange = middleRange;
 			p.outerRange = outerRange;
 			p.isStatic = true;
+			p.smType = smType;
 
-			LOCK_TT();
-			TID tid = m_tidCounter;
-			m_tidCounter++;  // Increase the counter of the DThread IDs
-
-			if (tid <= 0) {
-				printf("Error while inserting a DThread => The tid has to be greater that zero.\n");
-				exit(ERROR);
-			}
-
-			if (m_TemplateMemory.contains(tid)) {
-				printf("Error while inserting a DThread => the tid:%d is already used for another DThread.\n", tid);
-				exit(ERROR);
-			}
+			TID tid = allocateTID();
 
+			LOCK_TT();
 			m_pendingTTs.insert( { tid, p });
 			UNLOCK_TT();
 
@@ -269,71 +261,165 @@ class TSU
 		 * @param[in] ifp the pointer of the DThread's function
 		 * @param[in] tid	the Dthread's id
 		 * @param[in] nesting	the Dthread's nesting
+		 * @param[in] smType the storage of the DThread's Dynamic SM. DENSE_SM is not allowed, since the ranges of the Contexts are unknown.
 		 * @return the TID of the created DThread
 		 */
-		inline TID addDThread(IFP ifp, Nesting nesting) {
+		inline TID addDThread(IFP ifp, Nesting nesting, SMType smType = SMType::AUTO_SM) {
+			if (smType == SMType::DENSE_SM && nesting != Nesting::ZERO) {
+				printf("Error while inserting a DThread => The DENSE_SM storage requires the ranges of the Contexts.\n");
+				exit(ERROR);
+			}
+
 			PendingThreadTemplate p;
 			p.ifp = ifp;
 			p.nesting = nesting;
 			p.readyCount = 0;
+			p.innerRange = p.middleRange = p.outerRange = 0;
 			p.isStatic = false;
+			p.smType = smType;
+
+			TID tid = allocateTID();
 
 			LOCK_TT();
-			TID tid = m_tidCounter;
-			m_tidCounter++;  // Increase the counter of the DThread IDs
+			m_pendingTTs.insert( { tid, p });
+			UNLOCK_TT();
+
+			return tid;
+		}
+
+		/**
+		 * Sets the Scheduling Policy of a DThread, i.e. the method that is used for mapping its ready instances to the Kernels
+		 * @param[in] tid the Thread ID
+		 * @param[in] method the Scheduling Method
+		 * @param[in] value the Scheduling Value. For PRODUCER_AFFINE it is the queue depth above which the DYNAMIC placement is used and
+		 * for BLOCK it is the number of consecutive instances that are assigned to the same Kernel. If it is zero a default value is used.
+		 */
+		inline void setSchedulingPolicy(TID tid, SchedulingMethod method, UInt value) {
+			if (method == SchedulingMethod::CUSTOM) {
+				printf("Error while setting the Scheduling Policy => The CUSTOM Scheduling Method requires a Scheduling Function.\n");
+				exit(ERROR);
+			}
+
+			storeSchedulingPolicy(tid, method, value, nullptr);
+		}
 
-			if (tid <= 0) {
-				printf("Error while inserting a DThread => The tid has to be greater that zero.\n");
+		/**
+		 * Sets the CUSTOM Scheduling Policy of a DThread, i.e. a function returns the Kernel of each ready instance
+		 * @param[in] tid the Thread ID
+		 * @param[in] function maps the context of a ready instance to a Kernel. The result is taken modulo the number of Kernels.
+		 */
+		inline void setSchedulingPolicy(TID tid, SchedulingFunction function) {
+			if (!function) {
+				printf("Error while setting the Scheduling Policy => The Scheduling Function is empty.\n");
 				exit(ERROR);
 			}
 
-			if (m_TemplateMemory.contains(tid)) {
-				printf("Error while inserting a DThread => the tid:%d is already used for another DThread.\n", tid);
+			storeSchedulingPolicy(tid, SchedulingMethod::CUSTOM, 0, function);
+		}
+
+		/**
+		 * Sets the static Priority of a DThread. The ready instances with higher priority are executed first.
+		 * @param[in] tid the Thread ID
+		 * @param[in] priority the priority, from DEFAULT_PRIORITY (the lowest) up to PRIORITY_LEVELS - 1
+		 */
+		inline void setPriority(TID tid, UInt priority) {
+			if (priority >= PRIORITY_LEVELS) {
+				printf("Error while setting the Priority => The priority of DThread %d has to be less than %d.\n", tid, PRIORITY_LEVELS);
 				exit(ERROR);
 			}
 
-			m_pendingTTs.insert( { tid, p });
-			UNLOCK_TT();
+			storePriority(tid, priority, nullptr);
+		}
 
-			return tid;
+		/**
+		 * Sets the Priority of a DThread that is computed per context
+		 * @param[in] tid the Thread ID
+		 * @param[in] function returns the priority of a ready instance. Values above PRIORITY_LEVELS - 1 are treated as the highest priority.
+		 */
+		inline void setPriority(TID tid, PriorityFunction function) {
+			if (!function) {
+				printf("Error while setting the Priority => The Priority Function is empty.\n");
+				exit(ERROR);
+			}
+
+			storePriority(tid, DEFAULT_PRIORITY, function);
 		}
 
 		/**
-		 * Removes the DThread from the TSU
+		 * Removes the DThread from the TSU. Its TID can be reused by a new DThread.
 		 */
 		inline void removeDThread(TID tid) {
 
 			LOCK_TT();
+
+			// Remove the consumers of the DThread (if exist) before its TID becomes available to the new DThreads
+			m_GraphMemory.remove(tid);
+
 			if (!m_TemplateMemory.removeTemplate(tid)) {
 				printf("Error while removing a DThread => The tid:%d does not exists in Template Memory.\n", tid);
 				exit(ERROR);
 			}
 
-			// Remove the consumers of the DThread (if exist)
-			m_GraphMemory.remove(tid);
-
 			UNLOCK_TT();
 		}
 
+		/**
+		 * Restores the initial Ready Counts of the DThread's instances, such as, the DThread can be executed again
+		 * @param[in] tid the Thread ID
+		 * @note it has to be called when the DThreads are not executed, i.e. before or after the run functions
+		 */
+		inline void rearmDThread(TID tid) {
+			ThreadTemplate* threadTemplate = m_TemplateMemory.getTemplate(tid);
+
+			if (!threadTemplate) {
+				// The SM of a Pending DThread is allocated when the Dependency Graph is finalized
+				LOCK_TT();
+				bool isPending = (m_pendingTTs.find(tid) != m_pendingTTs.end());
+				UNLOCK_TT();
+
+				if (isPending)
+					return;
+
+				printf("Error while rearming a DThread => The tid:%d does not exists in Template Memory.\n", tid);
+				exit(ERROR);
+			}
+
+			m_TemplateMemory.resetTemplate(threadTemplate);
+		}
+
+		/**
+		 * Restores the initial Ready Counts of all the DThreads, such as, the Dependency Graph can be executed again
+		 * @note it has to be called when the DThreads are not executed, i.e. before or after the run functions
+		 */
+		void resetGraph();
+
 		/**
 		 * Decrements the Ready Count (RC) of a DThread which has Nesting-0
 		 */
 		inline void simpleUpdate(KernelID kernelID, TID tid) {
-			// If the IQ is full, put it in the Kernel's Unlimited IQ
-			if (!m_InputQueues[kernelID]->enqueue(tid, CREATE_N0())) {
+			// In decentralized mode the Kernel decrements the Ready Count by itself
+			if (isLocalUpdate(kernelID)) {
+				applyLocalUpdate(kernelID, tid, CREATE_N0(), nullptr);
+				return;
+			}
+
+			// The instances of the DThreads with RC=1 are scheduled by the calling Kernel (direct execution)
+			if (m_directExecution && scheduleDirectly(kernelID, tid, CREATE_N0(), nullptr))
+				return;
+
+			TSUShard& shard = getOwnerShard(tid);
+
+			// If the IQ is full, spill the update in the Kernel's Unlimited IQ
+			if (!shard.inputQueues[kernelID]->enqueue(tid, CREATE_N0())) {
 				IQ_Entry iqEntry;
 				iqEntry.context = CREATE_N0();
-				iqEntry.isMultiple = false;
+				iqEntry.type = IQ_SINGLE_UPDATE;
 				iqEntry.tid = tid;
 
-				try {
-					m_UnlimitedIQs[kernelID]->push(iqEntry);
-				}
-				catch (const std::exception& e) {
-					cout << "Error while inserting a simple update in UIQ: " << e.what() << endl;
-					exit(ERROR);
-				}
+				spillUpdate(shard, kernelID, iqEntry);
 			}
+
+			notifyUpdates(shard, kernelID);
 		}
 
 		/**
@@ -341,22 +427,29 @@ class TSU
 		 * @param[in] context the context of the DThread
 		 */
 		inline void update(KernelID kernelID, TID tid, context_t context) {
+			// In decentralized mode the Kernel decrements the Ready Count by itself
+			if (isLocalUpdate(kernelID)) {
+				applyLocalUpdate(kernelID, tid, context, nullptr);
+				return;
+			}
+
+			// The instances of the DThreads with RC=1 are scheduled by the calling Kernel (direct execution)
+			if (m_directExecution && scheduleDirectly(kernelID, tid, context, nullptr))
+				return;
+
+			TSUShard& shard = getOwnerShard(tid);
 
-			// If the IQ is full, put it in the Kernel's Unlimited IQ
-			if (!m_InputQueues[kernelID]->enqueue(tid, context)) {
+			// If the IQ is full, spill the update in the Kernel's Unlimited IQ
+			if (!shard.inputQueues[kernelID]->enqueue(tid, context)) {
 				IQ_Entry iqEntry;
 				iqEntry.context = context;
-				iqEntry.isMultiple = false;
+				iqEntry.type = IQ_SINGLE_UPDATE;
 				iqEntry.tid = tid;
 
-				try {
-					m_UnlimitedIQs[kernelID]->push(iqEntry);
-				}
-				catch (const std::exception& e) {
-					cout << "Error while inserting an update in UIQ: " << e.what() << endl;
-					exit(ERROR);
-				}
+				spillUpdate(shard, kernelID, iqEntry);
 			}
+
+			notifyUpdates(shard, kernelID);
 		}
 
 		/**
@@ -365,22 +458,30 @@ class TSU
 		 * @param[in] data the pointer to the data of the DThread
 		 */
 		inline void updateWithData(KernelID kernelID, TID tid, RInstance instance, void* data) {
-			// If the IQ is full, put it in the Kernel's Unlimited IQ
-			if (!m_InputQueues[kernelID]->enqueue(tid, instance, data)) {
+			// In decentralized mode the Kernel decrements the Ready Count by itself
+			if (isLocalUpdate(kernelID)) {
+				applyLocalUpdate(kernelID, tid, CREATE_N1(instance), data);
+				return;
+			}
+
+			// The instances of the DThreads with RC=1 are scheduled by the calling Kernel (direct execution)
+			if (m_directExecution && scheduleDirectly(kernelID, tid, CREATE_N1(instance), data))
+				return;
+
+			TSUShard& shard = getOwnerShard(tid);
+
+			// If the IQ is full, spill the update in the Kernel's Unlimited IQ
+			if (!shard.inputQueues[kernelID]->enqueue(tid, instance, data)) {
 				IQ_Entry iqEntry;
 				iqEntry.data = data;
 				iqEntry.context = CREATE_N1(instance);
-				iqEntry.isMultiple = false;
+				iqEntry.type = IQ_SINGLE_UPDATE;
 				iqEntry.tid = tid;
 
-				try {
-					m_UnlimitedIQs[kernelID]->push(iqEntry);
-				}
-				catch (const std::exception& e) {
-					cout << "Error while inserting an update with data in UIQ: " << e.what() << endl;
-					exit(ERROR);
-				}
+				spillUpdate(shard, kernelID, iqEntry);
 			}
+
+			notifyUpdates(shard, kernelID);
 		}
 
 		/**
@@ -389,22 +490,29 @@ class TSU
 		 * @param[in] maxContext the end of the context range
 		 */
 		inline void update(KernelID kernelID, TID tid, context_t context, context_t maxContext) {
+			// In decentralized mode the Kernel decrements the Ready Counts by itself
+			if (isLocalUpdate(kernelID)) {
+				applyLocalMultipleUpdate(kernelID, tid, context, maxContext);
+				return;
+			}
+
+			// The instances of the DThreads with RC=1 are scheduled by the calling Kernel (direct execution)
+			if (m_directExecution && scheduleRangeDirectly(kernelID, tid, context, maxContext))
+				return;
+
+			TSUShard& shard = getOwnerShard(tid);
 
-			if (!m_InputQueues[kernelID]->enqueue(tid, context, maxContext)) {
+			if (!shard.inputQueues[kernelID]->enqueue(tid, context, maxContext)) {
 				IQ_Entry iqEntry;
 				iqEntry.context = context;
 				iqEntry.maxContext = maxContext;
-				iqEntry.isMultiple = true;
+				iqEntry.type = IQ_MULTIPLE_UPDATE;
 				iqEntry.tid = tid;
 
-				try {
-					m_UnlimitedIQs[kernelID]->push(iqEntry);
-				}
-				catch (const std::exception& e) {
-					cout << "Error while inserting a multiple update in UIQ: " << e.what() << endl;
-					exit(ERROR);
-				}
+				spillUpdate(shard, kernelID, iqEntry);
 			}
+
+			notifyUpdates(shard, kernelID);
 		}
 
 		/**
@@ -413,16 +521,17 @@ class TSU
 		 * @param[in] tid the Thread ID of the DThread
 		 */
 		inline void updateAllConsSimple(KernelID kernelID, TID tid) {
-			// Get the Consumers of the DThread
-			ConsumerList* cons = getConsumers(tid);
+			const TID* cons = nullptr;
+			UInt numOfCons = getConsumerArray(tid, &cons);
 
-			if (!cons) {
-				printf("Error in function updateAllCons => The DThread with id:%d does not have consumers\n", tid);
-				exit(ERROR);
+			// One IQ entry updates all the consumers. The consumers of multiple TSU threads are updated one by one.
+			if (numOfCons > 1 && m_shardsNum == 1 && !isLocalUpdate(kernelID)) {
+				multicastUpdate(kernelID, tid, CREATE_N0(), CREATE_N0(), false);
+				return;
 			}
 
-			for (auto x : *cons)
-				simpleUpdate(kernelID, x);
+			for (UInt i = 0; i < numOfCons; ++i)
+				simpleUpdate(kernelID, cons[i]);
 		}
 
 		/**
@@ -432,16 +541,17 @@ class TSU
 		 * @param[in] context the context of the DThread
 		 */
 		inline void updateAllCons(KernelID kernelID, TID tid, context_t context) {
-			// Get the Consumers of the DThread
-			ConsumerList* cons = getConsumers(tid);
+			const TID* cons = nullptr;
+			UInt numOfCons = getConsumerArray(tid, &cons);
 
-			if (!cons) {
-				printf("Error in function updateAllCons => The DThread with id:%d does not have consumers\n", tid);
-				exit(ERROR);
+			// One IQ entry updates all the consumers. The consumers of multiple TSU threads are updated one by one.
+			if (numOfCons > 1 && m_shardsNum == 1 && !isLocalUpdate(kernelID)) {
+				multicastUpdate(kernelID, tid, context, context, false);
+				return;
 			}
 
-			for (auto x : *cons)
-				update(kernelID, x, context);
+			for (UInt i = 0; i < numOfCons; ++i)
+				update(kernelID, cons[i], context);
 		}
 
 		/**
@@ -452,16 +562,17 @@ class TSU
 		 * @param[in] maxContext the end of the context range
 		 */
 		inline void updateAllCons(KernelID kernelID, TID tid, context_t context, context_t maxContext) {
-			// Get the Consumers of the DThread
-			ConsumerList* cons = getConsumers(tid);
+			const TID* cons = nullptr;
+			UInt numOfCons = getConsumerArray(tid, &cons);
 
-			if (!cons) {
-				printf("Error in function updateAllCons => The DThread with id:%d does not have consumers\n", tid);
-				exit(ERROR);
+			// One IQ entry updates all the consumers. The consumers of multiple TSU threads are updated one by one.
+			if (numOfCons > 1 && m_shardsNum == 1 && !isLocalUpdate(kernelID)) {
+				multicastUpdate(kernelID, tid, context, maxContext, true);
+				return;
 			}
 
-			for (auto x : *cons)
-				update(kernelID, x, context, maxContext);
+			for (UInt i = 0; i < numOfCons; ++i)
+				update(kernelID, cons[i], context, maxContext);
 		}
 
 		/**
@@ -477,7 +588,9 @@ class TSU
 		 * @param consList the Thread IDs of the DThread's consumers
 		 */
 		inline void setConsumers(TID tid, ConsumerList consList) {
+			LOCK_TT();
 			m_GraphMemory.insert(tid, consList);
+			UNLOCK_TT();
 		}
 
 		/**
@@ -506,6 +619,95 @@ class TSU
 			return m_kernels[number]->getKernelID();
 		}
 
+		/**
+		 * Enables/disables the decentralized updates. If enabled, the Kernels decrement the Ready Counts of
+		 * their local updates by themselves and they execute the instances that become ready without the
+		 * intervention of the TSU. The TSU is used only for the updates that are not applied by the Kernels (e.g., remote updates).
+		 * @param[in] enable true for enabling the decentralized updates
+		 * @note call this function before sending any update
+		 */
+		inline void setDecentralizedUpdates(bool enable) {
+			m_decentralizedUpdates = enable;
+		}
+
+		/**
+		 * Enables/disables the direct execution. If enabled, the Kernels schedule the instances of the DThreads with Ready Count 1
+		 * in their own Work-Stealing Deques, since these instances are ready without updating any Synchronization Memory.
+		 * The updates of these DThreads do not pass through the Input Queues, the TSU and the Output Queues.
+		 * @param[in] enable true for enabling the direct execution
+		 * @note call this function before sending any update
+		 */
+		inline void setDirectExecution(bool enable) {
+			m_directExecution = enable;
+		}
+
+		/**
+		 * Sets the maximum number of nested DThreads that a Kernel executes inline, i.e. inside the DThread that made them ready,
+		 * instead of inserting them in its Work-Stealing Deque (direct execution and decentralized updates)
+		 * @param[in] depth the maximum nesting depth. Zero disables the inline execution.
+		 * @note the inline execution is not used in distributed mode, since the Data Forward Table holds the data of the running DThread
+		 */
+		inline void setInlineExecutionDepth(UInt depth) {
+			for (UInt i = 0; i < m_kernelsNum; ++i)
+				m_kernels[i]->setInlineExecutionDepth(depth);
+		}
+
+		/**
+		 * Enables/disables the work-stealing. If enabled, the TSU distributes the ready DThreads to the Kernels in a round-robin fashion and the
+		 * idle Kernels steal ready DThreads from the Work-Stealing Deques of the other Kernels.
+		 * @param[in] enable true for enabling the work-stealing
+		 * @note call this function before starting the Kernels
+		 */
+		inline void setWorkStealing(bool enable) {
+			m_workStealing = enable;
+
+			if (enable)
+				for (UInt i = 0; i < m_kernelsNum; ++i)
+					m_kernels[i]->enableWorkStealing(m_kernels, m_kernelsNum);
+		}
+
+		/**
+		 * Sets the number of the TSU threads (shards). The thread s applies the updates of the DThreads with tid % threads == s and it
+		 * inserts ready DThreads in the Output Queues of the Kernels with kernelID % threads == s.
+		 * @param[in] threads the number of the TSU threads. It is limited to the number of the Kernels and it is 1 in distributed mode.
+		 * @note call this function before starting the Kernels
+		 */
+		void setSchedulerThreads(UInt threads);
+
+		/**
+		 * @return the number of the TSU threads
+		 */
+		inline UInt getSchedulerThreads() const {
+			return m_shardsNum;
+		}
+
+		/**
+		 * Sets the maximum number of entries that the TSU processes from an Input Queue before moving to the next one
+		 * @param[in] burstSize the size of the burst (1 to IQ_MAX_BURST)
+		 */
+		inline void setInputQueueBurst(UInt burstSize) {
+			if (burstSize == 0 || burstSize > IQ_MAX_BURST) {
+				printf("Error while setting the Input Queue burst => The burst size has to be between 1 and %d.\n", IQ_MAX_BURST);
+				exit(ERROR);
+			}
+
+			m_burstSize = burstSize;
+		}
+
+		/**
+		 * @return true if the direct execution of the DThreads with Ready Count 1 is enabled
+		 */
+		inline bool isDirectExecutionEnabled() const {
+			return m_directExecution;
+		}
+
+		/**
+		 * @return true if the decentralized updates are enabled
+		 */
+		inline bool isDecentralizedUpdatesEnabled() const {
+			return m_decentralizedUpdates;
+		}
+
 		///////////////////////////////////////// For the Distributed Support /////////////////////////////////////////
 
 		/**
@@ -519,10 +721,12 @@ class TSU
 			if (!m_remoteInputQueue.enqueue(tid, context)) {
 				IQ_Entry iqEntry;
 				iqEntry.context = context;
-				iqEntry.isMultiple = false;
+				iqEntry.type = IQ_SINGLE_UPDATE;
 				iqEntry.tid = tid;
-				m_UnlimitedRIQ.push(iqEntry);
+				m_UnlimitedRIQ.enqueue(iqEntry);
 			}
+
+			wakeUp();  // The TSU may be parked
 		}
 
 		/**
@@ -537,10 +741,12 @@ class TSU
 				IQ_Entry iqEntry;
 				iqEntry.data = data;
 				iqEntry.context = context;
-				iqEntry.isMultiple = false;
+				iqEntry.type = IQ_SINGLE_UPDATE;
 				iqEntry.tid = tid;
-				m_UnlimitedRIQ.push(iqEntry);
+				m_UnlimitedRIQ.enqueue(iqEntry);
 			}
+
+			wakeUp();  // The TSU may be parked
 		}
 
 		/**
@@ -556,10 +762,12 @@ class TSU
 				IQ_Entry iqEntry;
 				iqEntry.context = context;
 				iqEntry.maxContext = maxContext;
-				iqEntry.isMultiple = true;
+				iqEntry.type = IQ_MULTIPLE_UPDATE;
 				iqEntry.tid = tid;
-				m_UnlimitedRIQ.push(iqEntry);
+				m_UnlimitedRIQ.enqueue(iqEntry);
 			}
+
+			wakeUp();  // The TSU may be parked
 		}
 
 		/**
@@ -574,6 +782,82 @@ class TSU
 		 */
 		void stopDist(void) {
 			m_isDistFinished = true;
+			m_shards[0]->doorbell.ring();
+		}
+
+		/**
+		 * Wakes up the TSU if it is parked (idle policy)
+		 * @note it costs nothing if the parking is disabled
+		 */
+		inline void wakeUp(void) {
+			if (m_idlePolicy.parkingEnabled)
+				m_shards[0]->doorbell.ring();
+		}
+
+		/**
+		 * Marks that a Kernel sent updates to a TSU thread and wakes up the thread if it is parked
+		 * @param[in] shard the TSU thread (shard) that receives the updates
+		 * @param[in] kernelID the ID of the Kernel
+		 */
+		inline void notifyUpdates(TSUShard& shard, KernelID kernelID) {
+			shard.pendingUpdates->mark(kernelID);
+
+			if (m_idlePolicy.parkingEnabled)
+				shard.doorbell.ring();  // The TSU thread may be parked
+		}
+
+		/**
+		 * Sets the idle policy of the Kernels, the TSU and the Network Manager
+		 * @param[in] spinIterations the number of idle iterations in which a thread busy-waits
+		 * @param[in] yieldIterations the number of idle iterations in which a thread yields its core (after the spinning)
+		 * @param[in] parkingEnabled if true, a thread parks after the spinning and the yielding until new work arrives
+		 * @param[in] parkTimeout the maximum time (in microseconds) that a thread stays parked
+		 * @note call this function before starting the Kernels
+		 */
+		inline void setIdlePolicy(UInt spinIterations, UInt yieldIterations, bool parkingEnabled, UInt parkTimeout) {
+			m_idlePolicy.spinIterations = spinIterations;
+			m_idlePolicy.yieldIterations = yieldIterations;
+			m_idlePolicy.parkingEnabled = parkingEnabled;
+			m_idlePolicy.parkTimeout = (parkTimeout > 0) ? parkTimeout : 1;
+		}
+
+		/**
+		 * @return the idle policy of the runtime threads
+		 */
+		inline const IdlePolicy& getIdlePolicy(void) const {
+			return m_idlePolicy;
+		}
+
+		/**
+		 * Sets the memory budget of the updates that are spilled in the Unlimited Input Queues of the Kernels.
+		 * When it is exhausted, a Kernel with a full Input Queue executes ready DThreads or waits instead of allocating memory.
+		 * The budget is a soft limit, since a Kernel exceeds it if waiting makes no progress (see applyBackpressure).
+		 * @param[in] bytes the memory budget in bytes. Zero means unlimited.
+		 * @note call this function before starting the Kernels
+		 */
+		inline void setSpillMemorySoftLimit(size_t bytes) {
+			m_spillBudget.maxBytes = (bytes == 0) ? 0 : std::max(bytes, sizeof(UIQ_Segment));  // At least one segment
+		}
+
+		/**
+		 * @return the backpressure counters of all the Kernels
+		 * @note call this function when the Kernels are idle, e.g. after the run() function
+		 */
+		inline SpillStatistics getSpillStatistics() {
+			SpillStatistics total = SpillStatistics();
+
+			for (UInt s = 0; s < m_shardsNum; ++s) {
+				for (UInt i = 0; i < m_kernelsNum; ++i) {
+					const SpillStatistics& stats = m_shards[s]->unlimitedIQs[i]->getStatistics();
+					total.throttledUpdates += stats.throttledUpdates;
+					total.executedDThreads += stats.executedDThreads;
+					total.forcedSpills += stats.forcedSpills;
+				}
+			}
+
+			total.allocatedBytes = m_spillBudget.allocatedBytes.load();
+			total.peakAllocatedBytes = m_spillBudget.peakBytes.load();
+			return total;
 		}
 
 		/**
@@ -624,11 +908,11 @@ class TSU
 		 * Prints information about the DThreads (TID, RC and Consumers)
 		 */
 		inline void printDThreadsInfo() {
-			TID tid = 0;
+			for (TID tid = 1; tid < m_TemplateMemory.getTIDBound(); ++tid) {
+				ThreadTemplate* threadTemplate = m_TemplateMemory.getTemplate(tid);
 
-			for (auto& x : m_TemplateMemory) {
-				if (x.isUsed) {
-					printf("Thread ID: %d => (RC=%d)", tid, x.readyCount);
+				if (threadTemplate) {
+					printf("Thread ID: %d => (RC=%d)", tid, threadTemplate->readyCount);
 
 					// Print the Consumers
 					printf(" [Consumers={");
@@ -641,16 +925,16 @@ class TSU
 
 					printf("}]\n");
 				}
-
-				tid++;
 			}
 		}
 
 		/**
-		 * Finalize the DDM Dependency Graph, i.e store the DThreads that their RC is not set, using the Consumer Lists
+		 * Finalize the DDM Dependency Graph, i.e store the DThreads that their RC is not set, using the Consumer Lists,
+		 * and build the flat (CSR) representation of the Consumer Lists
 		 */
 		inline void finalizeDependencyGraph() {
 			storePendingThreadTemplates();
+			m_GraphMemory.finalize();  // Build the read-only copy of the Consumer Lists that is used by the updates
 		}
 
 	private:
@@ -659,10 +943,14 @@ class TSU
 		TemplateMemory m_TemplateMemory;  // The Template Memory of the TSU
 		unsigned int m_kernelsNum;  // Indicates the number of the TSU's Kernels. A Kernel is a POSIX thread that executes the DThreads
 		Kernel** m_kernels;  // The Kernels of the system
-		InputQueue** m_InputQueues;  // The Input Queues of the Kernels
-		std::queue<IQ_Entry>** m_UnlimitedIQs;  // The Unlimited Input Queues holds the updates that failed to be stored in the IQs because their full
+		TSUShard** m_shards;  // The TSU threads. Each one holds the Input Queues of its DThreads and the Ready Backlogs of its Kernels.
+		UInt m_shardsNum;  // The number of the TSU threads
+		volatile bool m_areShardsFinished;  // Indicates that the execution is finished. This is used to stop the TSU threads 1 to M-1.
 		GraphMemory m_GraphMemory;  // The TSU's Graph Memory
-		UInt m_tidCounter;  // A counter that counts the number of DThreads that are created by the TSU automatically
+		bool m_workStealing;  // Indicates if the idle Kernels steal ready DThreads from the other Kernels
+		bool m_decentralizedUpdates;  // Indicates if the Kernels decrement the Ready Counts of their updates by themselves
+		bool m_directExecution;  // Indicates if the Kernels schedule the instances of the DThreads with Ready Count 1 by themselves
+		std::atomic<UInt> m_pendingInDeques;  // The number of instances that are inserted in the Work-Stealing Deques of the Kernels and they are not executed yet
 
 #ifdef PROTECT_TT
 		pthread_mutex_t m_ttMutex;  // Mutex that is used for protecting the Thread Templates (allocation/deallocation)
@@ -674,67 +962,727 @@ class TSU
 		/* ************** The variables below are used for the Distributed support ************** */
 		bool m_supportDistributed;  // Indicates if the TSU supports distributed execution
 		InputQueue m_remoteInputQueue;  // This Input Queue is used to store the updates from the remote nodes of the distributed system
-		std::queue<IQ_Entry> m_UnlimitedRIQ;  // holds the updates that failed to be stored in the Remote Input Queue because is full
+		UnlimitedInputQueue m_UnlimitedRIQ;  // holds the updates that failed to be stored in the Remote Input Queue because is full
+		SpillBudget m_spillBudget;  // The memory budget of the Unlimited Input Queues of the Kernels and of the Ready Backlogs
 		volatile bool m_isDistFinished;  // Indicates if the distributed execution finished. This is used to stop the TSU execution.
 		volatile bool m_idle;  // Indicates if the TSU has no more work to do
+		UInt m_burstSize;  // The maximum number of entries that are dequeued from an Input Queue at once
+		IdlePolicy m_idlePolicy;  // The idle policy of the Kernels, the TSU and the Network Manager
 
 		/**
 		 * Stores the next IQ_Entry in the iqEntry pointer.
-		 * The functions selects the data from the IQs and UIQs in a round-robin fashion.
+		 * The functions selects the data from the IQs and UIQs in a round-robin fashion. The entries of each queue are dequeued in bursts.
 		 * If the IQs and UIQs are empty we are selecting data from the Remote IQ in the
 		 * case we are in distributed mode.
+		 * @param[in] shard the TSU thread that owns the queues
 		 * @param iqEntry
+		 * @param[out] producer the ID of the Kernel that sent the update or NO_KERNEL_ID if the update is remote or it came from another TSU thread
 		 * @return false if there is no IQ_Entry available
 		 */
-		inline bool rrScheduler(IQ_Entry* iqEntry);
+		inline bool rrScheduler(TSUShard& shard, IQ_Entry* iqEntry, KernelID* producer);
+
+		/**
+		 * Executes an update command, i.e. decrements the Ready Count(s) of the DThread's instance(s) or schedules a ready instance
+		 * @param[in] shard the TSU thread that executes the update
+		 * @param[in] iqEntry the update command. Multicast entries are expanded before calling this function.
+		 * @param[in] producer the ID of the Kernel that sent the update or NO_KERNEL_ID if the update is remote
+		 */
+		inline void executeUpdate(TSUShard& shard, const IQ_Entry& iqEntry, KernelID producer);
+
+		/**
+		 * @return the TSU thread (shard) that applies the updates of a DThread
+		 * @param[in] tid the Thread ID of the DThread
+		 */
+		inline TSUShard& getOwnerShard(TID tid) const {
+			return *m_shards[(m_shardsNum == 1) ? 0 : tid % m_shardsNum];
+		}
+
+		/**
+		 * Creates the TSU threads (shards) and connects the Kernels with the threads that fill their Output Queues
+		 * @param[in] threads the number of the TSU threads
+		 */
+		void createShards(UInt threads);
+
+		/**
+		 * Deallocates the TSU threads (shards)
+		 */
+		void deleteShards();
+
+		/**
+		 * The operation of the TSU threads 1 to M-1. Each one applies the updates of its DThreads until the execution is finished.
+		 * @param[in] arg the shard of the thread
+		 */
+		static void* runShard(void* arg);
+
+		/**
+		 * Starts the TSU threads 1 to M-1
+		 */
+		void startShards();
+
+		/**
+		 * Stops the TSU threads 1 to M-1 and waits for them to finish
+		 */
+		void stopShards();
+
+		/**
+		 * @return true if the TSU threads 1 to M-1 have no updates in their hands
+		 */
+		inline bool areShardsIdle() const {
+			for (UInt s = 1; s < m_shardsNum; ++s)
+				if (!m_shards[s]->isIdle.load())
+					return false;
+
+			return true;
+		}
+
+		/**
+		 * Sends a ready instance that is mapped to a Kernel of another TSU thread to that thread, since only the owner of a Kernel
+		 * inserts ready DThreads in its Output Queues
+		 * @param[in] shard the TSU thread that made the instance ready
+		 * @param[in] selectedKernel the Kernel that the Scheduling Policy maps the instance to
+		 * @param[in] tid the Thread ID
+		 * @param[in] context the context of the ready instance
+		 * @param[in] data the data of the DThread
+		 */
+		inline void forwardReadyInstance(TSUShard& shard, KernelID selectedKernel, TID tid, const context_t& context, void* data) {
+			TSUShard& owner = *m_shards[selectedKernel % m_shardsNum];
+			UInt link = shard.getLinkIndex();
+
+			// The links are not bounded by the spill memory budget, since the sending thread cannot wait for the owner
+			if (!owner.inputQueues[link]->enqueueReady(tid, context, data)) {
+				IQ_Entry iqEntry;
+				iqEntry.tid = tid;
+				iqEntry.context = context;
+				iqEntry.type = IQ_READY_INSTANCE;
+				iqEntry.data = data;
+				owner.unlimitedIQs[link]->enqueue(iqEntry);
+			}
+
+			notifyUpdates(owner, link);
+		}
+
+		/**
+		 * Retrieves the consumers of a DThread. It terminates the program if the DThread does not have consumers.
+		 * @param[in] tid the Thread ID of the DThread
+		 * @param[out] consumers a pointer to the first consumer
+		 * @return the number of the consumers
+		 */
+		inline UInt getConsumerArray(TID tid, const TID** consumers) const {
+			UInt numOfCons = m_GraphMemory.getConsumerArray(tid, consumers);
+
+			if (numOfCons == 0) {
+				printf("Error in function updateAllCons => The DThread with id:%d does not have consumers\n", tid);
+				exit(ERROR);
+			}
+
+			return numOfCons;
+		}
+
+		/**
+		 * Stores an update that does not fit in the Kernel's Input Queue in the Kernel's Unlimited Input Queue
+		 * @param[in] shard the TSU thread that receives the update
+		 * @param[in] kernelID the ID of the Kernel that sends the update
+		 * @param[in] iqEntry the update
+		 */
+		inline void spillUpdate(TSUShard& shard, KernelID kernelID, const IQ_Entry& iqEntry) {
+			if (!shard.unlimitedIQs[kernelID]->tryEnqueue(iqEntry))
+				applyBackpressure(shard, kernelID, iqEntry);  // The spill memory budget is exhausted
+		}
+
+		/**
+		 * Called when the spill memory budget is exhausted. The calling Kernel executes ready DThreads or waits until the update
+		 * fits in its Input Queue or in its Unlimited Input Queue. If waiting makes no progress the budget is exceeded, i.e. it is a
+		 * soft limit. The exceeding updates are counted in the forcedSpills of the Kernel's SpillStatistics.
+		 * @param[in] shard the TSU thread that receives the update
+		 * @param[in] kernelID the ID of the Kernel that sends the update
+		 * @param[in] iqEntry the update
+		 */
+		void applyBackpressure(TSUShard& shard, KernelID kernelID, const IQ_Entry& iqEntry);
+
+		/**
+		 * Sends one update command for all the consumers of a DThread to the TSU
+		 * @param[in] kernelID the ID of the Kernel that sends the update
+		 * @param[in] tid the Thread ID of the producer DThread
+		 * @param[in] context the context of the consumers or the start of the context range
+		 * @param[in] maxContext the end of the context range
+		 * @param[in] isRange indicates if a range of instances of each consumer is updated
+		 */
+		inline void multicastUpdate(KernelID kernelID, TID tid, const context_t& context, const context_t& maxContext, bool isRange) {
+			TSUShard& shard = *m_shards[0];  // The multicast updates are sent only if there is a single TSU thread
+
+			// If the IQ is full, spill the update in the Kernel's Unlimited IQ
+			if (!shard.inputQueues[kernelID]->enqueueMulticast(tid, context, maxContext, isRange)) {
+				IQ_Entry iqEntry;
+				iqEntry.context = context;
+				iqEntry.maxContext = maxContext;
+				iqEntry.type = isRange ? IQ_MULTICAST_MULTIPLE_UPDATE : IQ_MULTICAST_UPDATE;
+				iqEntry.tid = tid;
+
+				spillUpdate(shard, kernelID, iqEntry);
+			}
+
+			notifyUpdates(shard, kernelID);
+		}
+
+		/**
+		 * @return true if all the Input Queues and Unlimited Input Queues of a TSU thread are empty
+		 * @param[in] shard the TSU thread
+		 */
+		inline bool allIQsAreEmpty(TSUShard& shard) {
+			if (!shard.pendingUpdates->isEmpty())
+				return false;
+
+			for (UInt i = 0; i < shard.queuesNum; ++i) {
+				if (!shard.inputQueues[i]->isEmpty() || !shard.unlimitedIQs[i]->isEmpty())
+					return false;
+			}
+
+			return true;
+		}
+
+		/**
+		 * @return true if there are updates in the Input Queues of a TSU thread (local or remote)
+		 * @param[in] shard the TSU thread
+		 */
+		inline bool hasUpdates(TSUShard& shard) {
+			return !allIQsAreEmpty(shard) || (m_supportDistributed && (!m_remoteInputQueue.isEmpty() || !m_UnlimitedRIQ.isEmpty()));
+		}
+
+		/**
+		 * @return true if there are updates or ready instances that are not executed yet
+		 * @note the queues of all Kernels are only scanned if no Kernel is marked in the Pending Work Maps, i.e. when the execution
+		 * is about to finish. The scan also marks the Kernels whose updates were left unmarked.
+		 * @note only the TSU thread 0 calls this function. The other TSU threads are checked twice: before and after the scan they have to be
+		 * idle and they must not have left the idle state in the meantime, i.e. they did not take any update during the scan.
+		 */
+		inline bool hasPendingWork() {
+			TSUShard& coordinator = *m_shards[0];
+
+			if (!coordinator.pendingUpdates->isEmpty() || coordinator.readyBacklogSize != 0 || m_pendingInDeques.load() != 0)
+				return true;
+
+			for (UInt s = 1; s < m_shardsNum; ++s) {
+				if (!m_shards[s]->isIdle.load())
+					return true;
+
+				m_shards[s]->observedActivations = m_shards[s]->activations.load();
+
+				if (!m_shards[s]->pendingUpdates->isEmpty())
+					return true;
+			}
+
+			for (UInt i = 0; i < m_kernelsNum; ++i) {
+				if (!m_kernels[i]->isOutputQueueEmpty())
+					return true;
+
+				for (UInt s = 0; s < m_shardsNum; ++s)
+					if (hasUnmarkedUpdates(*m_shards[s], i))
+						return true;
+			}
+
+			// The links between the TSU threads
+			for (UInt s = 0; s < m_shardsNum; ++s)
+				for (UInt i = m_kernelsNum; i < m_shards[s]->queuesNum; ++i)
+					if (hasUnmarkedUpdates(*m_shards[s], i))
+						return true;
+
+			/* A Kernel may have moved instances from its Output Queue to its Work-Stealing Deque during the scan. These instances are
+			 * either pending or executed, and the updates they sent are marked in the Pending Work Maps.
+			 */
+			if (m_pendingInDeques.load() != 0)
+				return true;
+
+			for (UInt s = 0; s < m_shardsNum; ++s)
+				if (!m_shards[s]->pendingUpdates->isEmpty())
+					return true;
+
+			for (UInt s = 1; s < m_shardsNum; ++s)
+				if (!m_shards[s]->isIdle.load() || m_shards[s]->activations.load() != m_shards[s]->observedActivations)
+					return true;
+
+			return false;
+		}
+
+		/**
+		 * Checks if an Input Queue of a TSU thread has updates and marks it in the thread's Pending Work Map, since its producer
+		 * may have left it unmarked
+		 * @param[in] shard the TSU thread
+		 * @param[in] index the index of the Input Queue in the queues of the thread
+		 * @return true if the Input Queue or its Unlimited Input Queue has updates
+		 */
+		inline bool hasUnmarkedUpdates(TSUShard& shard, UInt index) {
+			if (shard.inputQueues[index]->isEmpty() && shard.unlimitedIQs[index]->isEmpty())
+				return false;
+
+			notifyUpdates(shard, index);
+			return true;
+		}
+
+		/**
+		 * @return true if the Kernels have no ready DThreads to execute
+		 */
+		inline bool areKernelsIdle() {
+			for (UInt i = 0; i < m_kernelsNum; ++i)
+				if (!m_kernels[i]->isOutputQueueEmpty())
+					return false;
+
+			return m_pendingInDeques.load() == 0;
+		}
 
 		/**
-		 * @return true if all the Input Queues and Unlimited Input Queues are empty
+		 * @return true if a Kernel that has instances in the Ready Backlog of a TSU thread has drained its Output Queues
+		 * @param[in] shard the TSU thread
 		 */
-		inline bool allIQsAreEmpty();
+		inline bool canDrainReadyBacklogs(TSUShard& shard) {
+			if (shard.readyBacklogSize == 0)
+				return false;
+
+			for (UInt i = shard.id; i < m_kernelsNum; i += m_shardsNum)
+				if (!shard.readyBacklogs[i]->empty() && m_kernels[i]->isOutputQueueEmpty())
+					return true;
+
+			return false;
+		}
 
 		/**
-		 *	Gets the update commands from the Input Queues in a Round-Robin fashion and execute them.
+		 *	Gets the update commands from the Input Queues of a TSU thread in a Round-Robin fashion and execute them.
+		 *	@param[in] shard the TSU thread
+		 *	@return true if at least one update command is executed
 		 */
-		void getUpdatesAndExecute(void);
+		bool getUpdatesAndExecute(TSUShard& shard);
 
 		/**
 		 * Updates multiple contexts of the same DThread. The updateSingleContext method is used.
+		 * @param[in] shard the TSU thread that executes the update
 		 * @param tid the Thread ID
 		 * @param context[in] the start of the Context
 		 * @param maxContext[in] the end of the Context
 		 * @param[in] threadTemplate threadTemplate the Thread Template of the DThread that is going to be updated
+		 * @param[in] producer the ID of the Kernel that sent the update
 		 */
-		void updateMultipleContexts(TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate);
+		void updateMultipleContexts(TSUShard& shard, TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate, KernelID producer);
 
 		/**
 		 * Schedules multiple instances of the same DThread immediately
+		 * @param[in] shard the TSU thread that executes the update
 		 * @param[in] tid the Thread ID
 		 * @param[in] context the start of the Context
 		 * @param[in] maxContext the end of the Context
 		 * @param[in] threadTemplate threadTemplate the Thread Template of the DThread that is going to be updated
+		 * @param[in] producer the ID of the Kernel that sent the update
+		 */
+		void scheduleMultipleContexts(TSUShard& shard, TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate, KernelID producer);
+
+		/**
+		 * Schedules a range of ready instances of the same DThread as a single OQ entry
+		 * @param[in] shard the TSU thread that executes the update
+		 * @param[in] tid the Thread ID
+		 * @param[in] context the start of the Context
+		 * @param[in] maxContext the end of the Context
+		 * @param[in] threadTemplate the Thread Template of the DThread
+		 * @param[in] pieces the number of pieces in which the range is split before it is scheduled
+		 * @note with the work-stealing the range is scheduled in one piece, since the idle Kernels steal halves of it.
+		 * Otherwise, it is split in one piece per Kernel of the TSU thread.
+		 */
+		void scheduleRange(TSUShard& shard, TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate, UInt pieces);
+
+		/**
+		 * Inserts a ready instance (or range) in the Output Queue of a Kernel. If the Output Queues are full, the instance is stored in the
+		 * Ready Backlog of a Kernel and the TSU continues with the updates.
+		 * @param[in] shard the TSU thread that inserts the instance
+		 * @param[in] entry the ready instance
+		 * @param[in] priority the priority of the instance
+		 * @param[in] selectedKernel the Kernel that the Scheduling Policy maps the instance to or NO_KERNEL_ID if the instance is not mapped.
+		 * The Kernel has to be owned by the TSU thread.
 		 */
-		void scheduleMultipleContexts(TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate);
+		void placeReadyEntry(TSUShard& shard, const OQ_Entry& entry, UInt priority, KernelID selectedKernel);
+
+		/**
+		 * Inserts a ready instance in the Output Queue of a Kernel. If the Kernel's Ready Backlog is not empty the insertion fails,
+		 * in order to keep the order of the instances.
+		 * @param[in] shard the TSU thread that owns the Kernel
+		 * @param[in] kernelID the ID of the Kernel
+		 * @param[in] entry the ready instance
+		 * @param[in] priority the priority of the instance
+		 * @return true if the insertion was completed, otherwise false
+		 */
+		inline bool tryAddReadyEntry(TSUShard& shard, KernelID kernelID, const OQ_Entry& entry, UInt priority) {
+			return shard.readyBacklogs[kernelID]->empty() && m_kernels[kernelID]->addReadyEntry(entry, priority);
+		}
+
+		/**
+		 * Stores a ready instance that does not fit in the Output Queues in the Ready Backlog of a Kernel. The memory of the backlog
+		 * is charged to the spill memory budget, thus the Kernels are throttled while the TSU cannot keep up with them.
+		 * @param[in] shard the TSU thread that owns the Kernel
+		 * @param[in] kernelID the ID of the Kernel
+		 * @param[in] entry the ready instance
+		 * @param[in] priority the priority of the instance
+		 */
+		inline void addInReadyBacklog(TSUShard& shard, KernelID kernelID, const OQ_Entry& entry, UInt priority) {
+			BacklogEntry backlogEntry;
+			backlogEntry.entry = entry;
+			backlogEntry.priority = priority;
+
+			shard.readyBacklogs[kernelID]->push(backlogEntry);
+			shard.readyBacklogSize++;
+		}
+
+		/**
+		 * Moves the ready instances of the Ready Backlogs of a TSU thread in the Output Queues of their Kernels, as long as the Output Queues
+		 * have free space
+		 * @param[in] shard the TSU thread
+		 * @return true if at least one instance is moved
+		 */
+		bool drainReadyBacklogs(TSUShard& shard);
+
+		/**
+		 * @return the priority of a ready instance
+		 * @param[in] threadTemplate the Thread Template of the DThread
+		 * @param[in] context the context of the instance
+		 */
+		inline UInt getPriority(const ThreadTemplate* threadTemplate, const context_t& context) const {
+			if (!threadTemplate->priorityFunction)
+				return threadTemplate->priority;
+
+			UInt priority = threadTemplate->priorityFunction(context);
+			return (priority < PRIORITY_LEVELS) ? priority : PRIORITY_LEVELS - 1;
+		}
+
+		/**
+		 * Stores the Priority of a DThread in its Thread Template or in its Pending Thread Template
+		 * @param[in] tid the Thread ID
+		 * @param[in] priority the static priority
+		 * @param[in] function the Priority Function (null for a static priority)
+		 */
+		inline void storePriority(TID tid, UInt priority, PriorityFunction function) {
+			LOCK_TT();
+
+			// The Thread Templates of the Pending DThreads are created when the dependency graph is finalized
+			auto pendT = m_pendingTTs.find(tid);
+
+			if (pendT != m_pendingTTs.end()) {
+				pendT->second.priority = priority;
+				pendT->second.priorityFunction = function;
+			}
+			else {
+				ThreadTemplate* threadTemplate = m_TemplateMemory.getTemplate(tid);
+
+				if (!threadTemplate) {
+					printf("Error while setting the Priority => The DThread with id: %d does not exists.\n", tid);
+					exit(ERROR);
+				}
+
+				threadTemplate->priority = priority;
+				threadTemplate->priorityFunction = function;
+			}
+
+			UNLOCK_TT();
+		}
+
+		/**
+		 * @return true if the ready instances of a DThread can be scheduled in ranges, i.e. they are not mapped to specific Kernels,
+		 * they have the default priority and they do not carry data
+		 * @param[in] threadTemplate the Thread Template of the DThread
+		 */
+		inline bool isRangeSchedulable(const ThreadTemplate* threadTemplate) const {
+			return threadTemplate->schedMethod == SchedulingMethod::DYNAMIC && threadTemplate->priority == DEFAULT_PRIORITY && !threadTemplate->priorityFunction
+			    && (threadTemplate->nesting == Nesting::ONE || threadTemplate->nesting == Nesting::TWO || threadTemplate->nesting == Nesting::THREE);
+		}
+
+		/**
+		 * @return the ID of the Kernel with the least amount of work, i.e. the Kernel with the smallest Output Queue
+		 * @param[in] shard the TSU thread. Only its Kernels are checked.
+		 */
+		inline KernelID getLeastLoadedKernel(const TSUShard& shard) const {
+			// Assume that the first Kernel of the TSU thread has the least amount of work
+			int leastWork = m_kernels[shard.id]->getOutputQueueSize(), curOutputQueueSize;
+			KernelID leastWorkKernelID = shard.id;
+
+			// Check the other Kernels, to find the Kernel with the least amount of work
+			for (UInt i = shard.id + m_shardsNum; i < m_kernelsNum; i += m_shardsNum) {
+				curOutputQueueSize = m_kernels[i]->getOutputQueueSize();
+
+				if (curOutputQueueSize < leastWork) {
+					leastWork = curOutputQueueSize;
+					leastWorkKernelID = i;
+				}
+			}
+
+			return leastWorkKernelID;
+		}
 
 		/**
 		 * Used to schedule a DThread in the appropriate Kernel
+		 * @param[in] shard the TSU thread that made the DThread ready
 		 * @param tid the Thread ID of the scheduled DThread
 		 * @param context the context of the scheduled DThread
 		 * @param threadTemplate the Thread Template of the DThread that is going to be updated
 		 * @param data the data of the DThread
+		 * @param producer the ID of the Kernel that made the DThread ready or NO_KERNEL_ID if it is unknown
 		 */
-		void scheduleDThread(TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data);
+		void scheduleDThread(TSUShard& shard, TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data, KernelID producer);
 
 		/**
 		 * Updates a single Ready Count. If the Ready Count is equal to zero, it inserts the ready DThread in the appropriate Output Queue
+		 * @param[in] shard the TSU thread that executes the update
 		 * @param[in] tid the Thread ID
 		 * @param[in] context the context of the scheduled DThread
 		 * @param[in] threadTemplate the Thread Template of the DThread that is going to be updated
 		 * @param[in] data the data of the DThread
+		 * @param[in] producer the ID of the Kernel that sent the update
 		 * @note this function is used when a DThread has RC > 1 and Nesting != 0. Also, we have to check if the Contexts are valid, in the case we are
 		 * using the Static SM.
 		 */
-		void updateSingleContext(TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data);
+		void updateSingleContext(TSUShard& shard, TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data, KernelID producer);
+
+		/**
+		 * @return a new TID from the Template Memory
+		 */
+		inline TID allocateTID() {
+			TID tid = m_TemplateMemory.allocateTID();
+
+			if (tid == 0) {
+				printf("Error while inserting a DThread => The Template Memory is full.\n");
+				exit(ERROR);
+			}
+
+			return tid;
+		}
+
+		/**
+		 * Stores the Scheduling Policy of a DThread in its Thread Template or in its Pending Thread Template
+		 * @param[in] tid the Thread ID
+		 * @param[in] method the Scheduling Method
+		 * @param[in] value the Scheduling Value (zero for the default value of the method)
+		 * @param[in] function the Scheduling Function of the CUSTOM Scheduling Method
+		 */
+		inline void storeSchedulingPolicy(TID tid, SchedulingMethod method, UInt value, SchedulingFunction function) {
+			SchedulingMethod* methodPtr;
+			UInt* valuePtr;
+			SchedulingFunction* functionPtr;
+			UInt domainSize;  // The number of the DThread's instances (zero if it is unknown)
+
+			LOCK_TT();
+
+			// The Thread Templates of the Pending DThreads are created when the dependency graph is finalized
+			auto pendT = m_pendingTTs.find(tid);
+
+			if (pendT != m_pendingTTs.end()) {
+				methodPtr = &pendT->second.schedMethod;
+				valuePtr = &pendT->second.schedValue;
+				functionPtr = &pendT->second.schedFunction;
+				domainSize = pendT->second.innerRange * pendT->second.middleRange * pendT->second.outerRange;
+			}
+			else {
+				ThreadTemplate* threadTemplate = m_TemplateMemory.getTemplate(tid);
+
+				if (!threadTemplate) {
+					printf("Error while setting the Scheduling Policy => The DThread with id: %d does not exists.\n", tid);
+					exit(ERROR);
+				}
+
+				methodPtr = &threadTemplate->schedMethod;
+				valuePtr = &threadTemplate->schedValue;
+				functionPtr = &threadTemplate->schedFunction;
+				domainSize = threadTemplate->innerRange * threadTemplate->middleRange * threadTemplate->outerRange;
+			}
+
+			// Find the default Scheduling Values
+			if (value == 0 && method == SchedulingMethod::PRODUCER_AFFINE) {
+				value = DEFAULT_AFFINITY_THRESHOLD;
+			}
+			else if (value == 0 && method == SchedulingMethod::BLOCK) {
+				if (domainSize == 0) {
+					printf("Error while setting the Scheduling Policy => The block size of DThread %d has to be specified since its Context ranges are unknown.\n", tid);
+					exit(ERROR);
+				}
+
+				value = (domainSize + m_kernelsNum - 1) / m_kernelsNum;  // One block per Kernel
+			}
+
+			*methodPtr = method;
+			*valuePtr = value;
+			*functionPtr = function;
+
+			UNLOCK_TT();
+		}
+
+		/**
+		 * @return the linear index of a context, i.e. its position in the row-major order of the DThread's Context ranges.
+		 * If the ranges are unknown the parts of the context are added.
+		 * @param[in] threadTemplate the Thread Template of the DThread
+		 * @param[in] context the context
+		 */
+		inline unsigned long getLinearIndex(const ThreadTemplate* threadTemplate, const context_t& context) const {
+			unsigned long innerRange = threadTemplate->innerRange ? threadTemplate->innerRange : 1;
+			unsigned long middleRange = threadTemplate->middleRange ? threadTemplate->middleRange : 1;
+
+			switch (threadTemplate->nesting) {
+				case Nesting::ONE:
+				case Nesting::RECURSIVE:
+				case Nesting::CONTINUATION:
+					return GET_N1(context);
+
+				case Nesting::TWO:
+					return GET_N2_OUTER(context) * innerRange + GET_N2_INNER(context);
+
+				case Nesting::THREE:
+					return (GET_N3_OUTER(context) * middleRange + GET_N3_MIDDLE(context)) * innerRange + GET_N3_INNER(context);
+
+				default:
+					return 0;
+			}
+		}
+
+		/**
+		 * @return the Kernel that has to execute a ready instance according to the DThread's Scheduling Policy or NO_KERNEL_ID
+		 * if the Scheduling Method does not map the instances to specific Kernels (DYNAMIC and PRODUCER_AFFINE)
+		 * @param[in] threadTemplate the Thread Template of the DThread
+		 * @param[in] context the context of the ready instance
+		 */
+		inline KernelID getTargetKernel(const ThreadTemplate* threadTemplate, const context_t& context) const {
+			switch (threadTemplate->schedMethod) {
+				case SchedulingMethod::STATIC:
+					return getLinearIndex(threadTemplate, context) % m_kernelsNum;
+
+				case SchedulingMethod::BLOCK:
+					return (getLinearIndex(threadTemplate, context) / threadTemplate->schedValue) % m_kernelsNum;
+
+				case SchedulingMethod::CUSTOM:
+					return threadTemplate->schedFunction(context) % m_kernelsNum;
+
+				default:
+					return NO_KERNEL_ID;
+			}
+		}
+
+		/**
+		 * @return true if the update has to be applied by the calling Kernel (decentralized updates)
+		 * @param[in] kernelID the ID of the Kernel that sends the update
+		 */
+		inline bool isLocalUpdate(KernelID kernelID) const {
+			return m_decentralizedUpdates && m_kernels[kernelID]->isCurrentThread();
+		}
+
+		/**
+		 * Decrements the Ready Count of a DThread's instance by the calling Kernel (decentralized updates).
+		 * If the instance becomes ready it is inserted in the Kernel's Work-Stealing Deque.
+		 * @param[in] kernelID the ID of the calling Kernel
+		 * @param[in] tid the Thread ID
+		 * @param[in] context the context of the instance
+		 * @param[in] data the data of the DThread
+		 */
+		void applyLocalUpdate(KernelID kernelID, TID tid, const context_t& context, void* data);
+
+		/**
+		 * Decrements the Ready Counts of multiple instances of a DThread by the calling Kernel (decentralized updates)
+		 * @param[in] kernelID the ID of the calling Kernel
+		 * @param[in] tid the Thread ID
+		 * @param[in] context the start of the Context
+		 * @param[in] maxContext the end of the Context
+		 */
+		void applyLocalMultipleUpdate(KernelID kernelID, TID tid, const context_t& context, const context_t& maxContext);
+
+		/**
+		 * Schedules an instance of a DThread with Ready Count 1 in the calling Kernel (direct execution)
+		 * @param[in] kernelID the ID of the calling Kernel
+		 * @param[in] tid the Thread ID
+		 * @param[in] context the context of the instance
+		 * @param[in] data the data of the DThread
+		 * @return false if the update has to be sent to the TSU, i.e. the caller is not a Kernel or the DThread's Ready Count is not 1
+		 */
+		inline bool scheduleDirectly(KernelID kernelID, TID tid, const context_t& context, void* data) {
+			// The Ready Count is resolved by the per-TID flags of the Template Memory. The Thread Template is loaded only for RC=1.
+			if (!m_TemplateMemory.hasReadyCountOne(tid) || !m_kernels[kernelID]->isCurrentThread())
+				return false;
+
+			const ThreadTemplate* threadTemplate = m_TemplateMemory.getTemplate(tid);
+
+			// The DThread was removed concurrently. The TSU reports the DThreads that do not exist.
+			if (!threadTemplate)
+				return false;
+
+			scheduleLocally(kernelID, tid, context, threadTemplate, data);
+			return true;
+		}
+
+		/**
+		 * Schedules multiple instances of a DThread with Ready Count 1 in the calling Kernel (direct execution)
+		 * @param[in] kernelID the ID of the calling Kernel
+		 * @param[in] tid the Thread ID
+		 * @param[in] context the start of the Context
+		 * @param[in] maxContext the end of the Context
+		 * @return false if the update has to be sent to the TSU, i.e. the caller is not a Kernel or the DThread's Ready Count is not 1
+		 */
+		inline bool scheduleRangeDirectly(KernelID kernelID, TID tid, const context_t& context, const context_t& maxContext) {
+			if (!m_TemplateMemory.hasReadyCountOne(tid) || !m_kernels[kernelID]->isCurrentThread())
+				return false;
+
+			const ThreadTemplate* threadTemplate = m_TemplateMemory.getTemplate(tid);
+
+			if (!threadTemplate)
+				return false;
+
+			scheduleRangeLocally(kernelID, tid, context, maxContext, threadTemplate);
+			return true;
+		}
+
+		/**
+		 * Inserts the instances of a DThread with Ready Count 1 in the calling Kernel's Work-Stealing Deque. If their instances are not
+		 * mapped to specific Kernels, the whole range is inserted as a single entry.
+		 * @param[in] kernelID the ID of the calling Kernel
+		 * @param[in] tid the Thread ID
+		 * @param[in] context the start of the Context
+		 * @param[in] maxContext the end of the Context
+		 * @param[in] threadTemplate the Thread Template of the DThread
+		 */
+		void scheduleRangeLocally(KernelID kernelID, TID tid, const context_t& context, const context_t& maxContext, const ThreadTemplate* threadTemplate);
+
+		/**
+		 * Inserts an instance that became ready by the calling Kernel in the Kernel's Work-Stealing Deque. If the deque is full
+		 * the instance is forwarded to the TSU through the Kernel's Input Queue.
+		 * @param[in] kernelID the ID of the calling Kernel
+		 * @param[in] tid the Thread ID
+		 * @param[in] context the context of the ready instance
+		 * @param[in] threadTemplate the Thread Template of the DThread
+		 * @param[in] data the data of the DThread
+		 */
+		void scheduleLocally(KernelID kernelID, TID tid, const context_t& context, const ThreadTemplate* threadTemplate, void* data);
+
+		/**
+		 * Calls a function for each context of a context range
+		 * @param[in] nesting the DThread's nesting
+		 * @param[in] context the start of the Context
+		 * @param[in] maxContext the end of the Context
+		 * @param[in] func the function that is called for each context
+		 */
+		template <typename Func>
+		inline void forEachContext(Nesting nesting, const context_t& context, const context_t& maxContext, Func func) {
+			switch (nesting) {
+				case Nesting::ONE:
+					case Nesting::CONTINUATION:
+					for (cntx_1D_t cntxInn = GET_N1(context); cntxInn < (GET_N1(maxContext) + 1); ++cntxInn)
+						func(CREATE_N1(cntxInn));
+					break;
+
+				case Nesting::TWO:
+					for (cntx_2D_Out_t cntxOut = GET_N2_OUTER(context); cntxOut < (GET_N2_OUTER(maxContext) + 1U); ++cntxOut)
+						for (cntx_2D_In_t cntxInn = GET_N2_INNER(context); cntxInn < (GET_N2_INNER(maxContext) + 1U); ++cntxInn)
+							func(CREATE_N2(cntxOut, cntxInn));
+					break;
+
+				case Nesting::THREE:
+					for (cntx_3D_Out_t cntxOut = GET_N3_OUTER(context); cntxOut < (GET_N3_OUTER(maxContext) + 1U); ++cntxOut)
+						for (cntx_3D_Mid_t cntxMid = GET_N3_MIDDLE(context); cntxMid < (GET_N3_MIDDLE(maxContext) + 1U); ++cntxMid)
+							for (cntx_3D_In_t cntxInn = GET_N3_INNER(context); cntxInn < (GET_N3_INNER(maxContext) + 1U); ++cntxInn)
+								func(CREATE_N3(cntxOut, cntxMid, cntxInn));
+					break;
+
+				default:
+					// Do nothing
+					break;
+			}
+		}
 
 		/**
 		 * Stores the Pending Thread Templates, i.e. the DThread that their RC is not specified.
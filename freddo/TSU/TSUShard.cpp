@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * TSUShard.cpp
+ */
+
+#include "TSUShard.h"
+#include <new>
+
+/**
+ * Creates a shard of the TSU
+ * @param[in] tsu the TSU that runs the shard
+ * @param[in] shardID the ID of the shard
+ * @param[in] shardsNum the number of the shards of the TSU
+ * @param[in] kernelsNum the number of the Kernels of the TSU
+ * @param[in] budget the memory budget of the Unlimited Input Queues of the Kernels and of the Ready Backlogs
+ */
+TSUShard::TSUShard(TSU* tsu, UInt shardID, UInt shardsNum, UInt kernelsNum, SpillBudget* budget) {
+	this->tsu = tsu;
+	id = shardID;
+	this->shardsNum = shardsNum;
+	this->kernelsNum = kernelsNum;
+	ownedKernels = (kernelsNum - shardID + shardsNum - 1) / shardsNum;
+
+	// The links between the shards are needed only if there are multiple shards
+	queuesNum = (shardsNum > 1) ? kernelsNum + shardsNum : kernelsNum;
+
+	readyBacklogSize = 0;
+	rrIndex = sweepIndex = 0;
+	nextKernel = shardID;
+	burstCount = burstIndex = 0;
+	burstProducer = NO_KERNEL_ID;
+	isIdle.store(false, std::memory_order_relaxed);
+	activations.store(0, std::memory_order_relaxed);
+	observedActivations = 0;
+	pthreadID = 0;
+
+	try {
+		inputQueues = new InputQueue*[queuesNum];
+		unlimitedIQs = new UnlimitedInputQueue*[queuesNum];
+		readyBacklogs = new ReadyBacklog*[kernelsNum];
+		pendingUpdates = new PendingWorkMap(queuesNum);
+
+		// The spill memory budget applies only to the Kernels, since a shard cannot wait for another shard
+		for (UInt i = 0; i < queuesNum; ++i) {
+			inputQueues[i] = new InputQueue();
+			unlimitedIQs[i] = new UnlimitedInputQueue((i < kernelsNum) ? budget : nullptr);
+		}
+
+		// Only the backlogs of the owned Kernels are used
+		for (UInt i = 0; i < kernelsNum; ++i)
+			readyBacklogs[i] = ownsKernel(i) ? new ReadyBacklog(budget) : nullptr;
+	}
+	catch (std::bad_alloc&) {
+		printf("Error in TSUShard constructor => Memory allocation failed\n");
+		exit(ERROR);
+	}
+}
+
+/**
+ * Releases the memory allocated by the shard
+ */
+TSUShard::~TSUShard() {
+	for (UInt i = 0; i < queuesNum; ++i) {
+		delete inputQueues[i];
+		delete unlimitedIQs[i];
+	}
+
+	for (UInt i = 0; i < kernelsNum; ++i)
+		delete readyBacklogs[i];
+
+	delete[] inputQueues;
+	delete[] unlimitedIQs;
+	delete[] readyBacklogs;
+	delete pendingUpdates;
+}
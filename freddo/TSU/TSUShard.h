@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * TSUShard.h
+ *
+ *  Description: The scheduling state of one TSU thread (shard). The TSU can run M scheduler threads that partition the DThreads
+ *  by their Thread ID, i.e. the shard s applies the updates of the DThreads with tid % M == s. As such, the Synchronization
+ *  Memory of each DThread is still updated by a single thread.
+ *
+ *  Notes:
+ *  	- Each Kernel has one Input Queue and one Unlimited Input Queue per shard. It sends each update to the queues of the
+ *  	  shard that owns the updated DThread.
+ *  	- The Output Queues have a single producer, thus a shard inserts ready DThreads only in the Output Queues of the Kernels
+ *  	  that it owns (kernelID % M == s). A ready instance that is mapped to a Kernel of another shard is forwarded to that
+ *  	  shard through a shard-to-shard queue (link).
+ *  	- The shard 0 runs on the thread that calls the TSU's run function and it detects the termination of the execution
+ */
+
+#ifndef TSUSHARD_H_
+#define TSUSHARD_H_
+
+// Includes
+#include "../ddm_defs.h"
+#include "InputQueue.h"
+#include "UnlimitedInputQueue.h"
+#include "PendingWorkMap.h"
+#include "OutputQueue.h"
+#include "Doorbell.h"
+#include "ReadyBacklog.h"
+#include <atomic>
+#include <pthread.h>
+
+class TSU;
+
+class TSUShard {
+	public:
+
+		/**
+		 * Creates a shard of the TSU
+		 * @param[in] tsu the TSU that runs the shard
+		 * @param[in] shardID the ID of the shard
+		 * @param[in] shardsNum the number of the shards of the TSU
+		 * @param[in] kernelsNum the number of the Kernels of the TSU
+		 * @param[in] budget the memory budget of the Unlimited Input Queues of the Kernels and of the Ready Backlogs
+		 */
+		TSUShard(TSU* tsu, UInt shardID, UInt shardsNum, UInt kernelsNum, SpillBudget* budget);
+
+		/**
+		 * Releases the memory allocated by the shard
+		 */
+		~TSUShard();
+
+		/**
+		 * @return true if the shard inserts the ready DThreads of the Kernel with ID=kernelID
+		 */
+		inline bool ownsKernel(KernelID kernelID) const {
+			return kernelID % shardsNum == id;
+		}
+
+		/**
+		 * @return the index of the link, in the queues of a shard, through which this shard forwards ready instances
+		 */
+		inline UInt getLinkIndex() const {
+			return kernelsNum + id;
+		}
+
+		TSU* tsu;  // The TSU that runs the shard
+		UInt id;  // The ID of the shard
+		UInt shardsNum;  // The number of the shards of the TSU
+		UInt kernelsNum;  // The number of the Kernels of the TSU
+		UInt ownedKernels;  // The number of the Kernels whose Output Queues are filled by the shard
+		UInt queuesNum;  // The number of the Input Queues of the shard, i.e. one per Kernel and one per shard if there are multiple shards
+		InputQueue** inputQueues;  // The Input Queues of the Kernels, followed by the links of the shards
+		UnlimitedInputQueue** unlimitedIQs;  // Hold the entries that failed to be stored in the Input Queues because they were full
+		PendingWorkMap* pendingUpdates;  // Marks the Input Queues that have entries
+		ReadyBacklog** readyBacklogs;  // The ready instances that did not fit in the Output Queue of each owned Kernel
+		UInt readyBacklogSize;  // The number of the instances in the Ready Backlogs
+		UInt rrIndex;  // The current index of the Input Queue that the Round Robin scheduler uses
+		UInt sweepIndex;  // The index of the Input Queue that is checked when no queue is marked in pendingUpdates
+		UInt nextKernel;  // The owned Kernel that will receive the next ready DThread when the work-stealing is enabled
+		IQ_Entry burst[IQ_MAX_BURST];  // The entries that are dequeued from the current Input Queue and they are not processed yet
+		UInt burstCount;  // The number of entries in burst
+		UInt burstIndex;  // The next entry of burst that will be processed
+		KernelID burstProducer;  // The Kernel that sent the entries of burst or NO_KERNEL_ID if they came from another shard
+		Doorbell doorbell;  // The producers ring it when they make work available to the parked shard
+		std::atomic<bool> isIdle;  // Indicates if the shard has no updates in its hands. Only the shards 1 to M-1 use it.
+		std::atomic<unsigned long> activations;  // The number of times that the shard left the idle state
+		unsigned long observedActivations;  // The activations seen by the termination check of the shard 0
+		pthread_t pthreadID;  // The thread of the shard (shards 1 to M-1)
+};
+
+#endif /* TSUSHARD_H_ */
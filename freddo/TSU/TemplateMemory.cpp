@@ -31,25 +31,36 @@
  *	Creates the Template Memory
  */
 TemplateMemory::TemplateMemory() {
-	// Initialize the entries of the memory by just setting the isUsed member to false.
-	for (UInt i = 0; i < TM_SIZE; ++i) {
-		m_entries[i].isUsed = false;
-		m_entries[i].SM = nullptr;
-		m_entries[i].dynamicSM = nullptr;
-	}
+	// The chunks are allocated on demand
+	for (UInt i = 0; i < TM_MAX_CHUNKS; ++i)
+		m_chunks[i].store(nullptr, std::memory_order_relaxed);
+
+	for (UInt i = 0; i < TM_FLAG_WORDS; ++i)
+		m_readyCountOne[i].store(0, std::memory_order_relaxed);
+
+	m_nextTID.store(1, std::memory_order_relaxed);  // The TIDs start from 1
+	m_freeTIDs.store(0, std::memory_order_relaxed);
 }
 
 /**
  *	Releases the memory allocated by the Template Memory
  */
 TemplateMemory::~TemplateMemory() {
-	// Deallocates the Synchronization Memory of each entry
-	for (UInt i = 0; i < TM_SIZE; ++i) {
-		if (m_entries[i].isUsed && m_entries[i].SM)
-			delete m_entries[i].SM;
+	// Deallocates the Synchronization Memory of each entry and the chunks
+	for (UInt i = 0; i < TM_MAX_CHUNKS; ++i) {
+		ThreadTemplate* chunk = m_chunks[i].load(std::memory_order_relaxed);
+
+		if (!chunk)
+			continue;
 
-		if (m_entries[i].isUsed && m_entries[i].dynamicSM)
-			delete m_entries[i].dynamicSM;
+		for (UInt j = 0; j < TM_SIZE; ++j) {
+			if (chunk[j].isUsed && chunk[j].SM)
+				delete chunk[j].SM;
+
+			if (chunk[j].isUsed && chunk[j].dynamicSM)
+				delete chunk[j].dynamicSM;
+		}
+
+		delete[] chunk;
 	}
 }
-
@@ -30,11 +30,16 @@
  *  	- Ready Count (RC): the number of producer-threads
  *  	- Nesting: indicates the loop nesting level of the DThread
  *  	- Scheduling Policy: the method that is used by the TSU to map the ready DThreads to the cores. It consists of the Scheduling Method and Value.
+ *  	- Priority: the ready instances with higher priority are executed first. It is static or it is computed per context by a function.
  *  	- Consumer Threads: a list of the consumer-threads of the DThread
  *
  *  Note:
  *  	- The Template Memory is abbreviated as TM
- *  	- The TM is implemented as a Direct Mapped Array
+ *  	- The TM is implemented as a Direct Mapped Array that is split in chunks of TM_SIZE entries. The chunks are allocated on demand
+ *  	  and they are never moved or released before the destruction of the TM, thus the lookups are lock-free.
+ *  	- The TIDs of the removed DThreads are kept in a lock-free free list and they are reused by the new DThreads
+ *  	- The DThreads with Ready Count 1 are also marked in a bitmap that is indexed by the TIDs. The updates check it without
+ *  	  accessing the Thread Templates, in order to find the instances that are scheduled directly by the Kernels.
  */
 
 #ifndef TEMPLATEMEMORY_H_
@@ -43,18 +48,13 @@
 // Includes
 #include "../ddm_defs.h"
 #include <stdlib.h>
+#include <atomic>
 #include "SM/StaticSM.h"
-
-#if defined (USE_DYNAMIC_SM_UMAP) || defined(USE_DYNAMIC_SM_BOOST_UMAP)
-#include "SM/DynamicSM_UMAP.h"
-#elif defined (USE_DYNAMIC_SM_BTREE_MAP)
-#include "SM/DynamicSM_BTREEMAP.h"
-#else
-// Include nothing
-#endif
+#include "SM/DynamicSM.h"
 
 // Defining Constants
 #define NO_ENTRY_FOUND -1  	// Indicates that no entry found during search
+#define TM_FLAG_WORDS (TM_SIZE * TM_MAX_CHUNKS / 64)  // The number of 64-bit words of the per-TID flags
 
 // Defining the Thread Template
 typedef struct {
@@ -64,6 +64,15 @@ typedef struct {
 		bool isUsed = false;  // Indicates if the entry is used
 		StaticSM* SM = nullptr;  // The Synchronization Memory (Static)
 		DynamicSM* dynamicSM = nullptr;  // A dynamic Synchronization Memory
+		SchedulingMethod schedMethod = SchedulingMethod::DYNAMIC;  // The Scheduling Method
+		UInt schedValue = 0;  // The Scheduling Value, i.e. the parameter of the Scheduling Method
+		SchedulingFunction schedFunction = nullptr;  // Maps the contexts to the Kernels when the Scheduling Method is CUSTOM
+		UInt innerRange = 0;  // The range of the inner Context (zero if it is unknown)
+		UInt middleRange = 0;  // The range of the middle Context (zero if it is unknown)
+		UInt outerRange = 0;  // The range of the outer Context (zero if it is unknown)
+		UInt priority = DEFAULT_PRIORITY;  // The priority of the ready instances
+		PriorityFunction priorityFunction = nullptr;  // Returns the priority of each ready instance. If it is set the static priority is ignored.
+		std::atomic<TID> nextFreeTID { 0 };  // The next TID of the free list, if the entry is in the free list
 } ThreadTemplate;
 
 class TemplateMemory {
@@ -79,7 +88,35 @@ class TemplateMemory {
 		~TemplateMemory();
 
 		/**
-		 * Insert a new template in Template Memory and allocate a Static SM
+		 * Allocates a TID. The TIDs of the removed DThreads are reused first.
+		 * @return the allocated TID or zero if the Template Memory is full
+		 * @note it is safe to call this function from multiple threads concurrently
+		 */
+		inline TID allocateTID() {
+			unsigned long long head = m_freeTIDs.load(std::memory_order_acquire);
+
+			// Pop a TID from the free list. The upper half of the head is a tag that changes on every operation (avoids the ABA problem).
+			while ((TID) head != 0) {
+				TID tid = (TID) head;
+				unsigned long long next = (((head >> 32) + 1) << 32) | getEntry(tid)->nextFreeTID.load(std::memory_order_relaxed);
+
+				if (m_freeTIDs.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+					return tid;
+			}
+
+			// The free list is empty. Use a TID that has never been used.
+			TID tid = m_nextTID.fetch_add(1, std::memory_order_relaxed);
+
+			if (tid / TM_SIZE >= TM_MAX_CHUNKS)
+				return 0;
+
+			allocateChunk(tid / TM_SIZE);
+
+			return tid;
+		}
+
+		/**
+		 * Insert a new template in Template Memory and allocate a Static SM, unless the DThread selects a dynamic storage
 		 * @param[in] ifp the pointer of the DThread's function
 		 * @param[in] tid	the Dthread's id.
 		 * @param[in] nesting	the Dthread's nesting
@@ -87,19 +124,30 @@ class TemplateMemory {
 		 * @param[in] innerRange the range of the inner Context
 		 * @param[in] middleRange the range of the middle Context
 		 * @param[in] outerRange the range of the outer Context
+		 * @param[in] smType the storage of the DThread's SM. The Nesting-0 DThreads always use a Static SM.
+		 * @param[in] domain the domain of the Contexts of the Static SM or nullptr if all the Contexts of the ranges are valid
 		 * @return a pointer to the new template or nullptr if the insertion fails
 		 */
-		inline ThreadTemplate* addTemplate(IFP ifp, TID tid, Nesting nesting, ReadyCount readyCount, UInt innerRange, UInt middleRange, UInt outerRange) {
+		inline ThreadTemplate* addTemplate(IFP ifp, TID tid, Nesting nesting, ReadyCount readyCount, UInt innerRange, UInt middleRange, UInt outerRange,
+		    SMType smType = SMType::AUTO_SM, const ContextDomain* domain = nullptr) {
 
-			if (tid < 0 || tid >= TM_SIZE || m_entries[tid].isUsed)
+			if (tid == 0 || tid / TM_SIZE >= TM_MAX_CHUNKS || !m_chunks[tid / TM_SIZE].load(std::memory_order_acquire) || getEntry(tid)->isUsed)
 				return nullptr;
 
-			ThreadTemplate* threadTemplate = m_entries + tid;
+			ThreadTemplate* threadTemplate = getEntry(tid);
 			// Fill the empty entry
 			threadTemplate->ifp = ifp;
 			threadTemplate->isUsed = true;
 			threadTemplate->nesting = nesting;
 			threadTemplate->readyCount = readyCount;
+			threadTemplate->schedMethod = SchedulingMethod::DYNAMIC;
+			threadTemplate->schedValue = 0;
+			threadTemplate->schedFunction = nullptr;
+			threadTemplate->priority = DEFAULT_PRIORITY;
+			threadTemplate->priorityFunction = nullptr;
+			threadTemplate->innerRange = innerRange;
+			threadTemplate->middleRange = middleRange;
+			threadTemplate->outerRange = outerRange;
 
 			// If a DThread has RC=1 do not allocate an SM. We will schedule this kind of DThreads immediately.
 			if (readyCount > 1) {
@@ -108,14 +156,19 @@ class TemplateMemory {
 					if (nesting == Nesting::ZERO)
 						innerRange = middleRange = outerRange = 1;
 
-					threadTemplate->SM = new StaticSM(nesting, readyCount, innerRange, middleRange, outerRange);
+					// The dynamic storages ignore the ranges of the Contexts
+					if (nesting == Nesting::ZERO || smType == SMType::AUTO_SM || smType == SMType::DENSE_SM)
+						threadTemplate->SM = new StaticSM(nesting, readyCount, innerRange, middleRange, outerRange, domain);
+					else
+						threadTemplate->dynamicSM = new DynamicSM(readyCount, smType);
 				}
 				catch (std::bad_alloc&) {
-					printf("Error while allocating Static SM => Memory allocation failed\n");
+					printf("Error while allocating the SM => Memory allocation failed\n");
 					exit(ERROR);
 				}
 			}
 
+			setReadyCountOne(tid, readyCount == 1);  // Mark the TID after the Thread Template is filled
 			return threadTemplate;
 		}
 
@@ -125,19 +178,28 @@ class TemplateMemory {
 		 * @param[in] tid	the Dthread's id.
 		 * @param[in] nesting	the Dthread's nesting
 		 * @param[in] readyCount the Dthread's Ready Count, i.e. the number of its producer-threads
+		 * @param[in] smType the storage of the DThread's Dynamic SM (HASH_SM, BTREE_SM, SPARSE_SM or AUTO_SM)
+		 * @param[in] initialCapacity the initial number of slots of the HASH_SM storage
 		 * @return a pointer to the new template or nullptr if the insertion fails
 		 */
-		inline ThreadTemplate* addTemplate(IFP ifp, TID tid, Nesting nesting, ReadyCount readyCount) {
+		inline ThreadTemplate* addTemplate(IFP ifp, TID tid, Nesting nesting, ReadyCount readyCount, SMType smType = SMType::AUTO_SM,
+		    size_t initialCapacity = DYNAMIC_SM_INITIAL_CAPACITY) {
 
-			if (tid < 0 || tid >= TM_SIZE || m_entries[tid].isUsed)
+			if (tid == 0 || tid / TM_SIZE >= TM_MAX_CHUNKS || !m_chunks[tid / TM_SIZE].load(std::memory_order_acquire) || getEntry(tid)->isUsed)
 				return nullptr;
 
-			ThreadTemplate* threadTemplate = m_entries + tid;
+			ThreadTemplate* threadTemplate = getEntry(tid);
 			// Fill the empty entry
 			threadTemplate->ifp = ifp;
 			threadTemplate->isUsed = true;
 			threadTemplate->nesting = nesting;
 			threadTemplate->readyCount = readyCount;
+			threadTemplate->schedMethod = SchedulingMethod::DYNAMIC;
+			threadTemplate->schedValue = 0;
+			threadTemplate->schedFunction = nullptr;
+			threadTemplate->priority = DEFAULT_PRIORITY;
+			threadTemplate->priorityFunction = nullptr;
+			threadTemplate->innerRange = threadTemplate->middleRange = threadTemplate->outerRange = 0;
 
 			// If a DThread has RC=1 do not allocate an SM. We will schedule this kind of DThreads immediately.
 			if (readyCount > 1) {
@@ -154,7 +216,7 @@ class TemplateMemory {
 				else {
 					try {
 						// Allocate a dynamic SM
-						threadTemplate->dynamicSM = new DynamicSM(readyCount);
+						threadTemplate->dynamicSM = new DynamicSM(readyCount, smType, initialCapacity);
 					}
 					catch (std::bad_alloc&) {
 						printf("Error while allocating Dynamic SM => Memory allocation failed\n");
@@ -163,50 +225,81 @@ class TemplateMemory {
 				}
 			}
 
+			setReadyCountOne(tid, readyCount == 1);  // Mark the TID after the Thread Template is filled
 			return threadTemplate;
 		}
 
 		/**
-		 * Removes a thread template from the Template Memory
+		 * Removes a thread template from the Template Memory. Its TID is inserted in the free list.
 		 * @param[in] tid the Dthread's id.
 		 * @return true if the template removed successfully, otherwise false
 		 */
 		inline bool removeTemplate(TID tid) {
+			ThreadTemplate* threadTemplate = getTemplate(tid);
 
-			if (tid < 0 || tid >= TM_SIZE)
-				return false;
-
-			if (m_entries[tid].isUsed) {
-				m_entries[tid].isUsed = false;  // Set the entry as unused
+			if (!threadTemplate)
+				return false;  // The entry is not used
 
-				// Deallocate the Static SM
-				if (m_entries[tid].SM) {
-					delete m_entries[tid].SM;
-					m_entries[tid].SM = nullptr;
-				}
+			setReadyCountOne(tid, false);
+			threadTemplate->isUsed = false;  // Set the entry as unused
 
-				// Deallocate the Dynamic SM
-				if (m_entries[tid].dynamicSM) {
-					delete m_entries[tid].dynamicSM;
-					m_entries[tid].dynamicSM = nullptr;
-				}
+			// Deallocate the Static SM
+			if (threadTemplate->SM) {
+				delete threadTemplate->SM;
+				threadTemplate->SM = nullptr;
+			}
 
-				return true;
+			// Deallocate the Dynamic SM
+			if (threadTemplate->dynamicSM) {
+				delete threadTemplate->dynamicSM;
+				threadTemplate->dynamicSM = nullptr;
 			}
 
-			return false;  // The entry is not used
+			releaseTID(tid);
+
+			return true;
+		}
+
+		/**
+		 * Restores the initial Ready Counts of the instances of a Thread Template. The memory of its SM is reused.
+		 * @param[in] threadTemplate the Thread Template
+		 */
+		inline void resetTemplate(ThreadTemplate* threadTemplate) {
+			if (threadTemplate->SM)
+				threadTemplate->SM->reset();
+
+			if (threadTemplate->dynamicSM)
+				threadTemplate->dynamicSM->reset();
 		}
 
 		/**
 		 * Retrieves a Thread Template with a specific id
 		 * @param[in] tid the DThread's id
 		 * @return a pointer to the Thread Template if the search was successful, otherwise nullptr
+		 * @note the lookup is lock-free
 		 */
 		inline ThreadTemplate* getTemplate(TID tid) const {
-			if (tid < 0 || tid >= TM_SIZE || !m_entries[tid].isUsed)
+			if (tid / TM_SIZE >= TM_MAX_CHUNKS)
+				return nullptr;
+
+			ThreadTemplate* chunk = m_chunks[tid / TM_SIZE].load(std::memory_order_acquire);
+
+			if (!chunk || !chunk[tid & (TM_SIZE - 1)].isUsed)
 				return nullptr;
 
-			return const_cast<ThreadTemplate*>(m_entries + tid);
+			return chunk + (tid & (TM_SIZE - 1));
+		}
+
+		/**
+		 * @param[in] tid the DThread's id
+		 * @return true if the DThread exists and its Ready Count is 1
+		 * @note the lookup is lock-free and it does not access the Thread Template
+		 */
+		inline bool hasReadyCountOne(TID tid) const {
+			if (tid >= TM_SIZE * TM_MAX_CHUNKS)
+				return false;
+
+			return (m_readyCountOne[tid / 64].load(std::memory_order_acquire) >> (tid & 63)) & 1;
 		}
 
 		/**
@@ -214,30 +307,94 @@ class TemplateMemory {
 		 * @return true if the Template Memory contains the tid, otherwise false
 		 */
 		inline bool contains(TID tid) const {
-			return (tid >= 0 && tid < TM_SIZE && m_entries[tid].isUsed);
+			return getTemplate(tid) != nullptr;
+		}
+
+		/**
+		 * @return an upper bound of the TIDs that are allocated, i.e. all TIDs are less than this value
+		 */
+		inline TID getTIDBound() const {
+			return m_nextTID.load(std::memory_order_relaxed);
 		}
 
 		/**
 		 * Print the contents of the TM's Used Entries
 		 */
 		inline void printUsedEntries() const {
-			for (UInt i = 0; i < TM_SIZE; ++i)
-				if (m_entries[i].isUsed) {
-					printf("TID: %d, Nesting: %d, RC: %d\n", i, m_entries[i].nesting, m_entries[i].readyCount);
-				}
+			for (TID tid = 1; tid < getTIDBound(); ++tid) {
+				ThreadTemplate* threadTemplate = getTemplate(tid);
+
+				if (threadTemplate)
+					printf("TID: %d, Nesting: %d, RC: %d\n", tid, threadTemplate->nesting, threadTemplate->readyCount);
+			}
 		}
 
-		ThreadTemplate* begin() {
-			return &m_entries[0];
+	private:
+		std::atomic<ThreadTemplate*> m_chunks[TM_MAX_CHUNKS];  // The chunks of the Template Memory. The entry of a TID is in the chunk TID / TM_SIZE.
+		std::atomic<TID> m_nextTID;  // The smallest TID that has never been allocated
+		std::atomic<unsigned long long> m_freeTIDs;  // The head of the free list of TIDs. The lower 32 bits hold the TID and the upper 32 bits a tag.
+		std::atomic<unsigned long long> m_readyCountOne[TM_FLAG_WORDS];  // One bit for each TID. It is set if the DThread exists and its RC is 1.
+
+		/**
+		 * @return the entry of an allocated TID
+		 * @param[in] tid the DThread's id
+		 */
+		inline ThreadTemplate* getEntry(TID tid) const {
+			return m_chunks[tid / TM_SIZE].load(std::memory_order_acquire) + (tid & (TM_SIZE - 1));
+		}
+
+		/**
+		 * Allocates a chunk of the Template Memory, if it is not already allocated
+		 * @param[in] chunk the index of the chunk
+		 */
+		inline void allocateChunk(UInt chunk) {
+			if (m_chunks[chunk].load(std::memory_order_acquire))
+				return;
+
+			ThreadTemplate* entries;
+			ThreadTemplate* expected = nullptr;
+
+			try {
+				entries = new ThreadTemplate[TM_SIZE];
+			}
+			catch (std::bad_alloc&) {
+				printf("Error while allocating a chunk of the Template Memory => Memory allocation failed\n");
+				exit(ERROR);
+			}
+
+			// Another thread may allocate the same chunk concurrently
+			if (!m_chunks[chunk].compare_exchange_strong(expected, entries, std::memory_order_acq_rel, std::memory_order_acquire))
+				delete[] entries;
 		}
 
-		ThreadTemplate* end() {
-			return &m_entries[TM_SIZE];
+		/**
+		 * Marks or unmarks a TID as a DThread with Ready Count 1
+		 * @param[in] tid the DThread's id
+		 * @param[in] value true for marking the TID
+		 */
+		inline void setReadyCountOne(TID tid, bool value) {
+			unsigned long long mask = 1ULL << (tid & 63);
+
+			if (value)
+				m_readyCountOne[tid / 64].fetch_or(mask, std::memory_order_release);
+			else
+				m_readyCountOne[tid / 64].fetch_and(~mask, std::memory_order_release);
 		}
 
-	private:
-		ThreadTemplate m_entries[TM_SIZE];  // The entries of the Template Memory. It is a full associative memory.
+		/**
+		 * Inserts a TID in the free list
+		 * @param[in] tid the DThread's id
+		 */
+		inline void releaseTID(TID tid) {
+			ThreadTemplate* entry = getEntry(tid);
+			unsigned long long head = m_freeTIDs.load(std::memory_order_relaxed), newHead;
 
+			do {
+				entry->nextFreeTID.store((TID) head, std::memory_order_relaxed);
+				newHead = (((head >> 32) + 1) << 32) | tid;
+			}
+			while (!m_freeTIDs.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+		}
 };
 
 #endif /* TEMPLATEMEMORY_H_ */
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * UnlimitedInputQueue.cpp
+ */
+
+#include "UnlimitedInputQueue.h"
+#include <new>
+
+/**
+ *	Creates an Unlimited Input Queue
+ *	@param[in] budget the memory budget of the queue's segments or nullptr if the queue is unlimited
+ */
+UnlimitedInputQueue::UnlimitedInputQueue(SpillBudget* budget) {
+	m_tailSegment = newSegment();
+
+	if (!m_tailSegment) {
+		printf("Error in UnlimitedInputQueue constructor => Memory allocation failed\n");
+		exit(ERROR);
+	}
+
+	m_headSegment.store(m_tailSegment, std::memory_order_relaxed);
+	m_head.store(0, std::memory_order_relaxed);
+	m_tail = 0;
+	m_freeSegments = nullptr;
+	m_recycledSegments.store(nullptr, std::memory_order_relaxed);
+	m_budget = budget;
+	m_statistics = SpillStatistics();
+}
+
+/**
+ *	Releases the memory allocated by the Unlimited Input Queue
+ */
+UnlimitedInputQueue::~UnlimitedInputQueue() {
+	releaseSegments(m_headSegment.load(std::memory_order_relaxed), true);
+	releaseSegments(m_freeSegments, false);
+	releaseSegments(m_recycledSegments.load(std::memory_order_relaxed), false);
+}
+
+/**
+ * Allocates a new segment and charges it to the memory budget
+ * @param[in] ignoreBudget if true, the segment is allocated even if the memory budget is exhausted
+ * @return the new segment or nullptr if the memory budget is exhausted or the allocation failed
+ */
+UIQ_Segment* UnlimitedInputQueue::allocateSegment(bool ignoreBudget) {
+	if (m_budget && !m_budget->charge(sizeof(UIQ_Segment), ignoreBudget))
+		return nullptr;
+
+	UIQ_Segment* segment = newSegment();
+
+	if (!segment && m_budget)
+		m_budget->release(sizeof(UIQ_Segment));
+
+	return segment;
+}
+
+/**
+ * Allocates a new segment without charging the memory budget
+ * @return the new segment or nullptr if the allocation failed
+ */
+UIQ_Segment* UnlimitedInputQueue::newSegment() {
+	UIQ_Segment* segment = new (std::nothrow) UIQ_Segment;
+
+	if (!segment)
+		return nullptr;
+
+	segment->tail.store(0, std::memory_order_relaxed);
+	segment->next.store(nullptr, std::memory_order_relaxed);
+	segment->nextRecycled = nullptr;
+
+	return segment;
+}
+
+/**
+ * Releases the segments of a list
+ * @param[in] segment the first segment of the list
+ * @param[in] isChain indicates if the list is linked through the next field (the chain) or the nextRecycled field
+ */
+void UnlimitedInputQueue::releaseSegments(UIQ_Segment* segment, bool isChain) {
+	while (segment) {
+		UIQ_Segment* next = isChain ? segment->next.load(std::memory_order_relaxed) : segment->nextRecycled;
+		delete segment;
+		segment = next;
+	}
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * UnlimitedInputQueue.h
+ *
+ *  Description: Holds the updates that failed to be stored in an Input Queue because it was full.
+ *  The queue is a chain of fixed-size segments. The producer appends a new segment when the last one is full and
+ *  the consumer recycles the segments that it has drained.
+ *
+ *  Notes:
+ *  	- The Unlimited Input Queue is abbreviated as UIQ
+ *  	- This queue is a lock-free implementation which is intended for use by a single consumer-thread (the TSU) and a single
+ *  	  producer-thread (a Kernel or the Network Manager)
+ *  	- The drained segments are returned to the producer through a stack of recycled segments. Only the producer
+ *  	  removes segments from this stack and it removes all of them at once, thus the stack does not suffer from the ABA problem.
+ *  	- A segment is allocated only when there is no recycled segment, i.e. the steady state is allocation-free
+ *  	- The allocated segments can be bounded by a memory budget that is shared by multiple queues (SpillBudget)
+ *  	- The position of the head is atomic, thus any thread can check if the queue is empty (e.g. the termination check of the TSU).
+ *  	  The drained segments are recycled and not released, thus a stale head segment is always valid memory.
+ */
+
+#ifndef UNLIMITEDINPUTQUEUE_H_
+#define UNLIMITEDINPUTQUEUE_H_
+
+// Includes
+#include "../ddm_defs.h"
+#include "InputQueue.h"
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../Error.h"
+
+// Defining a segment of the UIQ
+struct UIQ_Segment {
+		IQ_Entry entries[UIQ_SEGMENT_SIZE];  // The entries of the segment
+		std::atomic<UInt> tail;  // The number of the entries that are stored in the segment. It is only changed by the producer.
+		std::atomic<UIQ_Segment*> next;  // The next segment of the chain. It is set by the producer when the segment is full.
+		UIQ_Segment* nextRecycled;  // The next segment in the stack of the recycled segments
+};
+
+// The memory budget of the spilled updates. It is shared by the Unlimited Input Queues of the Kernels and the Ready Backlogs of the TSU.
+struct SpillBudget {
+		std::atomic<size_t> allocatedBytes{0};  // The memory of the segments that are allocated beyond the first segment of each queue
+		std::atomic<size_t> peakBytes{0};  // The maximum value of allocatedBytes
+		size_t maxBytes = 0;  // The soft limit of allocatedBytes. Zero means unlimited.
+
+		/**
+		 * Charges the memory of a new segment to the budget
+		 * @param[in] bytes the size of the segment
+		 * @param[in] ignoreLimit if true, the segment is charged even if the soft limit is exceeded
+		 * @return true if the segment is charged or false if it does not fit in the soft limit
+		 */
+		inline bool charge(size_t bytes, bool ignoreLimit) {
+			size_t allocated = allocatedBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+			if (maxBytes != 0 && allocated > maxBytes && !ignoreLimit) {
+				allocatedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+				return false;
+			}
+
+			// Keep the peak, in order to report how far the soft limit was exceeded
+			size_t peak = peakBytes.load(std::memory_order_relaxed);
+
+			while (allocated > peak && !peakBytes.compare_exchange_weak(peak, allocated, std::memory_order_relaxed))
+				;
+
+			return true;
+		}
+
+		/**
+		 * Returns the memory of a released segment to the budget
+		 * @param[in] bytes the size of the segment
+		 */
+		inline void release(size_t bytes) {
+			allocatedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+		}
+};
+
+// Counts how often the producers of the Unlimited Input Queues reached the spill memory budget
+typedef struct {
+		unsigned long long throttledUpdates;  // The updates that found the Input Queue full and the spill memory budget exhausted
+		unsigned long long executedDThreads;  // The ready DThreads that were executed by the throttled Kernels while waiting
+		unsigned long long forcedSpills;  // The updates that were spilled beyond the budget, since waiting made no progress
+		size_t allocatedBytes;  // The memory of the segments that are allocated beyond the first segment of each queue (or Ready Backlog)
+		size_t peakAllocatedBytes;  // The maximum value of allocatedBytes. It is above the soft limit only if there are forced spills.
+} SpillStatistics;
+
+class UnlimitedInputQueue {
+	public:
+
+		/**
+		 *	Creates an Unlimited Input Queue
+		 *	@param[in] budget the memory budget of the queue's segments or nullptr if the queue is unlimited
+		 */
+		UnlimitedInputQueue(SpillBudget* budget = nullptr);
+
+		/**
+		 *	Releases the memory allocated by the Unlimited Input Queue
+		 */
+		~UnlimitedInputQueue();
+
+		/**
+		 * @return true if the Unlimited Input Queue is empty
+		 * @note If a thread other than the consumer calls this function, the result is exact only when the consumer is not dequeuing
+		 */
+		inline bool isEmpty(void) const {
+			const UIQ_Segment* segment = m_headSegment.load(std::memory_order_acquire);
+			const UInt head = m_head.load(std::memory_order_relaxed);
+
+			return head == segment->tail.load(std::memory_order_acquire) && segment->next.load(std::memory_order_acquire) == nullptr;
+		}
+
+		/**
+		 * Enqueue an IQ entry. The memory budget is ignored.
+		 * @param[in] entry the IQ entry
+		 * @note Only the producer calls this function
+		 */
+		inline void enqueue(const IQ_Entry& entry) {
+			if (!tryEnqueue(entry, true)) {
+				printf("Error while spilling an update => Memory allocation failed\n");
+				exit(ERROR);
+			}
+		}
+
+		/**
+		 * Enqueue an IQ entry if it fits in the memory budget
+		 * @param[in] entry the IQ entry
+		 * @param[in] ignoreBudget if true, a new segment is allocated even if the memory budget is exhausted
+		 * @return true if the enqueue was completed or false if a new segment is needed and the memory budget is exhausted
+		 * @note Only the producer calls this function
+		 */
+		inline bool tryEnqueue(const IQ_Entry& entry, bool ignoreBudget = false) {
+			// The last segment has free entries
+			if (m_tail != UIQ_SEGMENT_SIZE) {
+				m_tailSegment->entries[m_tail++] = entry;
+				m_tailSegment->tail.store(m_tail, std::memory_order_release);  // Publish the entry
+				return true;
+			}
+
+			// Fill the first entry of a new segment and then append the segment to the chain
+			UIQ_Segment* segment = getSegment(ignoreBudget);
+
+			if (!segment)
+				return false;
+
+			segment->entries[0] = entry;
+			segment->tail.store(1, std::memory_order_relaxed);
+			segment->next.store(nullptr, std::memory_order_relaxed);
+
+			m_tailSegment->next.store(segment, std::memory_order_release);  // Publish the segment
+			m_tailSegment = segment;
+			m_tail = 1;
+			return true;
+		}
+
+		/**
+		 * Dequeue up to maxItems IQ entries
+		 * @param[out] items the buffer that will be filled with the dequeued entries
+		 * @param[in] maxItems the maximum number of entries that will be dequeued
+		 * @return the number of the dequeued entries
+		 * @note Only the consumer (the TSU) calls this function
+		 */
+		inline UInt dequeue(IQ_Entry* const items, UInt maxItems) {
+			UIQ_Segment* segment = m_headSegment.load(std::memory_order_relaxed);
+			UInt head = m_head.load(std::memory_order_relaxed);
+			UInt count = 0;
+
+			while (count < maxItems) {
+				// Move to the next segment if the current one is drained
+				if (head == UIQ_SEGMENT_SIZE) {
+					UIQ_Segment* next = segment->next.load(std::memory_order_acquire);
+
+					if (!next)
+						break;  // The queue is empty
+
+					m_head.store(0, std::memory_order_relaxed);
+					m_headSegment.store(next, std::memory_order_release);
+					recycleSegment(segment);
+					segment = next;
+					head = 0;
+				}
+
+				const UInt tail = segment->tail.load(std::memory_order_acquire);
+
+				if (head == tail)
+					break;  // The queue is empty
+
+				while (head != tail && count < maxItems)
+					items[count++] = segment->entries[head++];
+			}
+
+			m_head.store(head, std::memory_order_release);
+			return count;
+		}
+
+		/**
+		 * Dequeue an IQ entry
+		 * @param[out] item the pointer of an IQ entry that will be filled with the head's value
+		 * @return true if the dequeue was completed or false if the queue was empty
+		 * @note Only the consumer (the TSU) calls this function
+		 */
+		inline bool dequeue(IQ_Entry* const item) {
+			return dequeue(item, 1) == 1;
+		}
+
+		/**
+		 * @return the counters of the backpressure that is applied to the queue's producer
+		 * @note The counters are updated by the producer, thus read them when the producer is idle
+		 */
+		inline SpillStatistics& getStatistics() {
+			return m_statistics;
+		}
+
+	private:
+		// The consumer's cache line
+		std::atomic<UIQ_Segment*> m_headSegment;  // The segment that holds the head (front) of the queue. It is only changed by the consumer.
+		std::atomic<UInt> m_head;  // The index of the head in m_headSegment
+		char m_padHead[CACHE_LINE_SIZE - sizeof(std::atomic<UIQ_Segment*>) - sizeof(std::atomic<UInt>)];  // Keeps the consumer's and the producer's data in different cache lines
+
+		// The producer's cache line
+		UIQ_Segment* m_tailSegment;  // The segment that holds the tail (rear) of the queue. It is only changed by the producer.
+		UIQ_Segment* m_freeSegments;  // The recycled segments that are owned by the producer
+		UInt m_tail;  // The index of the tail in m_tailSegment
+		char m_padTail[CACHE_LINE_SIZE - 2 * sizeof(UIQ_Segment*) - sizeof(UInt)];  // Keeps the producer's data and the recycled segments in different cache lines
+
+		std::atomic<UIQ_Segment*> m_recycledSegments;  // The stack of the segments that are drained by the consumer
+		SpillBudget* m_budget;  // The memory budget of the queue's segments or nullptr if the queue is unlimited
+		SpillStatistics m_statistics;  // The backpressure counters. They are only changed by the producer.
+
+		/**
+		 * @param[in] ignoreBudget if true, a new segment is allocated even if the memory budget is exhausted
+		 * @return a segment from the recycled segments, a new segment if there are no recycled segments or
+		 * nullptr if the memory budget is exhausted
+		 * @note Only the producer calls this function
+		 */
+		inline UIQ_Segment* getSegment(bool ignoreBudget) {
+			// Take all the recycled segments at once
+			if (!m_freeSegments)
+				m_freeSegments = m_recycledSegments.exchange(nullptr, std::memory_order_acquire);
+
+			if (!m_freeSegments)
+				return allocateSegment(ignoreBudget);
+
+			UIQ_Segment* segment = m_freeSegments;
+			m_freeSegments = segment->nextRecycled;
+
+			return segment;
+		}
+
+		/**
+		 * Returns a drained segment to the producer
+		 * @param[in] segment the drained segment
+		 * @note Only the consumer calls this function
+		 */
+		inline void recycleSegment(UIQ_Segment* segment) {
+			UIQ_Segment* top = m_recycledSegments.load(std::memory_order_relaxed);
+
+			do {
+				segment->nextRecycled = top;
+			}
+			while (!m_recycledSegments.compare_exchange_weak(top, segment, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		/**
+		 * Allocates a new segment and charges it to the memory budget
+		 * @param[in] ignoreBudget if true, the segment is allocated even if the memory budget is exhausted
+		 * @return the new segment or nullptr if the memory budget is exhausted or the allocation failed
+		 */
+		UIQ_Segment* allocateSegment(bool ignoreBudget);
+
+		/**
+		 * Allocates a new segment without charging the memory budget
+		 * @return the new segment or nullptr if the allocation failed
+		 */
+		static UIQ_Segment* newSegment();
+
+		/**
+		 * Releases the segments of a list
+		 * @param[in] segment the first segment of the list
+		 * @param[in] isChain indicates if the list is linked through the next field (the chain) or the nextRecycled field
+		 */
+		static void releaseSegments(UIQ_Segment* segment, bool isChain);
+};
+
+#endif /* UNLIMITEDINPUTQUEUE_H_ */
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2017 George Matheou (cs07mg2@cs.ucy.ac.cy)
+ *
+ * This file is part of FREDDO.
+ *
+ * FREDDO is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FREDDO is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FREDDO.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * WorkStealingDeque.h
+ *
+ * Description: Holds the ready DThreads of a Kernel that can be stolen by the other Kernels.
+ *
+ *  Notes:
+ *  	- This is a bounded Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models", PPoPP 2013)
+ *  	- Only the owner (the Kernel) can push and pop entries at the bottom of the deque
+ *  	- Any thread (the thieves) can steal entries from the top of the deque
+ */
+
+#ifndef WORKSTEALINGDEQUE_H_
+#define WORKSTEALINGDEQUE_H_
+
+// Includes
+#include "../ddm_defs.h"
+#include "OutputQueue.h"
+#include <atomic>
+
+// The mask used to map an index in the circular buffer. Notice that the WSQ_SIZE has to be in the power of 2.
+#define WSQ_MASK (WSQ_SIZE - 1)
+
+class WorkStealingDeque {
+	public:
+
+		/**
+		 *	Creates a Work-Stealing Deque
+		 */
+		WorkStealingDeque();
+
+		/**
+		 *	Releases the memory allocated by the Work-Stealing Deque
+		 */
+		~WorkStealingDeque();
+
+		/**
+		 * @return true if the deque is empty
+		 * @note the result is approximate if the deque is used concurrently
+		 */
+		inline bool isEmpty(void) const {
+			return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @return the number of entries in the deque
+		 * @note the result is approximate if the deque is used concurrently
+		 */
+		inline UInt getSize(void) const {
+			long size = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+			return (size > 0) ? size : 0;
+		}
+
+		/**
+		 * @return true if the deque is full
+		 * @note only the owner is allowed to call this function
+		 */
+		inline bool isFull(void) const {
+			return (m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_acquire)) >= WSQ_SIZE;
+		}
+
+		/**
+		 * Pushes an entry at the bottom of the deque
+		 * @param[in] entry the ready DThread
+		 * @return true if the push was completed or false if the deque was full
+		 * @note only the owner is allowed to call this function
+		 */
+		inline bool push(const OQ_Entry& entry) {
+			long b = m_bottom.load(std::memory_order_relaxed);
+			long t = m_top.load(std::memory_order_acquire);
+
+			if (b - t >= WSQ_SIZE)
+				return false;  // The deque is full
+
+			m_entries[b & WSQ_MASK] = entry;
+			std::atomic_thread_fence(std::memory_order_release);
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+
+			return true;
+		}
+
+		/**
+		 * Pushes an entry at the bottom of the deque
+		 * @param[in] ifp the pointer of the ready DThread's function
+		 * @param[in] context the ready DThread's context
+		 * @param[in] nesting the ready DThread's nesting
+		 * @param[in] data the pointer to the arguments of the DThread
+		 * @return true if the push was completed or false if the deque was full
+		 * @note only the owner is allowed to call this function
+		 */
+		inline bool push(IFP ifp, context_t context, Nesting nesting, void* data) {
+			OQ_Entry entry;
+			entry.ifp = ifp;
+			entry.context = context;
+			entry.nesting = nesting;
+			entry.data = data;
+
+			return push(entry);
+		}
+
+		/**
+		 * Pops an entry from the bottom of the deque
+		 * @param[out] item the entry that will be filled with the bottom's value
+		 * @return true if the pop was completed or false if the deque was empty
+		 * @note only the owner is allowed to call this function
+		 */
+		inline bool pop(OQ_Entry* const item) {
+			long b = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			long t = m_top.load(std::memory_order_relaxed);
+
+			if (t > b) {
+				// The deque is empty
+				m_bottom.store(b + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			*item = m_entries[b & WSQ_MASK];
+
+			if (t == b) {
+				// This is the last entry. Race against the thieves.
+				bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				m_bottom.store(b + 1, std::memory_order_relaxed);
+				return won;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Steals an entry from the top of the deque
+		 * @param[out] item the entry that will be filled with the top's value
+		 * @return true if the steal was completed or false if the deque was empty or another thread won the entry
+		 * @note any thread is allowed to call this function
+		 */
+		inline bool steal(OQ_Entry* const item) {
+			long t = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			long b = m_bottom.load(std::memory_order_acquire);
+
+			if (t >= b)
+				return false;  // The deque is empty
+
+			*item = m_entries[t & WSQ_MASK];
+
+			return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<long> m_top;  // Points to the top of the deque. It is changed by the thieves and by the owner when the last entry is popped.
+		char m_padTop[CACHE_LINE_SIZE - sizeof(std::atomic<long>)];  // Keeps the top and the bottom in different cache lines
+		std::atomic<long> m_bottom;  // Points to the bottom of the deque. It is changed only by the owner.
+		char m_padBottom[CACHE_LINE_SIZE - sizeof(std::atomic<long>)];  // Keeps the bottom and the entries in different cache lines
+		OQ_Entry m_entries[WSQ_SIZE];  // The entries of the deque
+};
+
+#endif /* WORKSTEALINGDEQUE_H_ */
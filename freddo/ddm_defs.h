@@ -37,15 +37,49 @@
 
 //// Defines ////
 
-// The defines below used for implementing different implementations of Dynamic SM
+// The defines below select the storage of the Dynamic SMs of the DThreads that do not select one (SMType::AUTO_SM)
 #define USE_DYNAMIC_SM_UMAP					// Use the std's unordered map
-//#define USE_DYNAMIC_SM_BOOST_UMAP			// Use the boost's unordered map
+//#define USE_DYNAMIC_SM_BOOST_UMAP			// Use the boost's unordered map (replaces the std's unordered map of SMType::SPARSE_SM)
 //#define USE_DYNAMIC_SM_BTREE_MAP			// Use the google's BTREE map
+//#define USE_DYNAMIC_SM_FLAT_MAP			// Use an open-addressing hash table that does not allocate memory per instance
 
 //// Size of the Data-Structures ////
 #define IQ_SIZE 8192	// The size of the Input Queue. NOTE: It has to be in the power of 2.
 #define OQ_SIZE 8192	// The size of the Output Queue. NOTE: It has to be in the power of 2.
-#define TM_SIZE 256		// The size of the Template Memory. NOTE: It has to be in the power of 2.
+#define TM_SIZE 256		// The number of entries of each chunk of the Template Memory. NOTE: It has to be in the power of 2.
+#define TM_MAX_CHUNKS 4096	// The maximum number of chunks of the Template Memory, i.e. up to TM_SIZE * TM_MAX_CHUNKS - 1 DThreads can exist at the same time
+#define DYNAMIC_SM_INITIAL_CAPACITY 64	// The default initial number of slots of the open-addressing hash table Dynamic SMs (HASH_SM). NOTE: It is rounded up to a power of 2.
+#define STATIC_SM_LAZY_MIN_SIZE 65536	// The minimum size (in bytes) of a Static SM whose pages are mapped on their first update and released when all their instances are ready
+#define CONTEXT_DOMAIN_MAX_CONSTRAINTS 8	// The maximum number of affine constraints of a Context domain (see ContextDomain.h)
+#define UIQ_SEGMENT_SIZE 1024	// The number of entries of each segment of the Unlimited Input Queues
+#define READY_BACKLOG_SEGMENT_SIZE 256	// The number of entries of each segment of the Ready Backlogs of the TSU
+#define DEFAULT_SPILL_MEMORY_SOFT_LIMIT 0	// The default soft limit (in bytes) of the memory of the updates that are spilled in the Unlimited Input Queues. Zero means unlimited.
+#define SPILL_THROTTLE_LIMIT 128	// The number of idle iterations after which a throttled Kernel exceeds the spill memory budget, in order to avoid deadlocks
+#define DEFAULT_INLINE_DEPTH 0	// The default number of nested DThreads that a Kernel executes inline, instead of inserting them in its Work-Stealing Deque
+#define SPILL_MAX_HELP_DEPTH 8	// The maximum number of nested DThreads that a throttled Kernel executes while it waits for space in its queues
+#define IQ_MAX_BURST 256	// The maximum number of entries that the TSU dequeues from an Input Queue before moving to the next one
+#define DEFAULT_IQ_BURST 32	// The default number of entries that the TSU dequeues from an Input Queue before moving to the next one
+#define DEFAULT_SCHEDULER_THREADS 1	// The default number of the TSU threads (shards) that apply the updates
+#define WSQ_SIZE 8192	// The size of the Work-Stealing Deque of each Kernel. NOTE: It has to be in the power of 2.
+#define WSQ_TRANSFER_BATCH 32	// The maximum number of ready DThreads that a Kernel moves from its Output Queue into its Work-Stealing Deque at once
+
+//// Scheduling Constants ////
+#define NO_KERNEL_ID ((KernelID) -1)	// Indicates that the Kernel that made a DThread ready is unknown (e.g. remote updates)
+#define DEFAULT_AFFINITY_THRESHOLD 64	// The default queue depth above which a PRODUCER_AFFINE instance falls back to the DYNAMIC placement
+
+//// Thread Identification Constants ////
+#define MAIN_THREAD_KERNEL_ID 0	// The KernelID of the thread that initializes FREDDO. Its updates (e.g. the initial ones) are sent through the Input Queue of Kernel 0.
+#define EXTERNAL_THREAD_ID ((KernelID) -2)	// The KernelID of the threads that are neither Kernels nor the main thread. They are not allowed to send updates.
+
+//// Idle Policy Constants ////
+#define DEFAULT_PARK_TIMEOUT 1000	// The default maximum time (in microseconds) that an idle thread stays parked
+
+//// Priority Constants ////
+#define PRIORITY_LEVELS 3	// The number of priority levels of the ready DThreads. Each level above the default one adds an Output Queue to every Kernel.
+#define DEFAULT_PRIORITY 0	// The priority of the DThreads that do not set one. It is the lowest priority.
+
+//// Hardware Constants ////
+#define CACHE_LINE_SIZE 64	// The size of a cache line in bytes. It is used for avoiding false sharing.
 
 //// Constants about the Distributed Recursion Support
 // The bits used for store the node id in a context value. We want this to create unique context values
@@ -58,6 +92,31 @@ typedef enum {
 	ZERO = 0x00, ONE = 0x01, TWO = 0x02, THREE = 0x03, RECURSIVE = 0x04, CONTINUATION = 0x05
 } Nesting;
 
+// Defining the Scheduling Method, i.e. the method that is used by the TSU to map the ready DThreads to the Kernels
+typedef enum {
+	DYNAMIC = 0x00,  // The TSU selects the Kernel (least-loaded or round-robin when work-stealing is enabled)
+	PRODUCER_AFFINE = 0x01,  // The instance runs on the Kernel that made it ready, unless the Kernel's queues exceed the Scheduling Value
+	STATIC = 0x02,  // The instance runs on the Kernel: linear index of the context modulo the number of Kernels
+	BLOCK = 0x03,  // The contexts are partitioned into blocks of Scheduling Value instances and the blocks are assigned to the Kernels cyclically
+	CUSTOM = 0x04  // The instance runs on the Kernel returned by a user-supplied function of the context
+} SchedulingMethod;
+
+// Defining the storage of the Synchronization Memory of a DThread
+typedef enum {
+	AUTO_SM = 0x00,  // A Static SM if the ranges of the Contexts are known, otherwise the Dynamic SM selected by USE_DYNAMIC_SM_*
+	DENSE_SM = 0x01,  // A Static SM, i.e. one Ready Count per context of the ranges. The ranges of the Contexts are required.
+	HASH_SM = 0x02,  // A Dynamic SM implemented as an open-addressing hash table. It does not allocate memory per instance.
+	BTREE_SM = 0x03,  // A Dynamic SM implemented as a BTREE map. It is compact when the pending contexts are clustered.
+	SPARSE_SM = 0x04  // A Dynamic SM implemented as an unordered map. Its memory follows the number of the pending contexts.
+} SMType;
+
+// Defining the parts of a Context. They are used in the constraints of the Context domains.
+typedef enum {
+	INNER_CONTEXT = 0x00,
+	MIDDLE_CONTEXT = 0x01,
+	OUTER_CONTEXT = 0x02
+} ContextPart;
+
 //// Defining Types ////
 typedef unsigned int 				TID;  			// The type of the DThread's Identifier
 typedef unsigned int 				KernelID;  		// The Kernel's Identifier. It is used as an argument in a DThread function.
@@ -122,4 +181,10 @@ typedef struct {
 // This std::function is used to call a function when data is received for a GAS address
 using GASOnReceiveFunction = std::function<void*(ReceivedSegmentInfo&)>;
 
+// This std::function maps the context of a ready instance to a Kernel (used by the CUSTOM Scheduling Method)
+using SchedulingFunction = std::function<KernelID(context_t)>;
+
+// This std::function returns the priority of a ready instance based on its context
+using PriorityFunction = std::function<UInt(context_t)>;
+
 #endif /* DDM_DEFS_H_ */
@@ -90,6 +90,49 @@ namespace ddm {
 				return m_tid;
 			}
 
+			/**
+			 * Restores the initial Ready Counts of the DThread's instances, such as, they can be executed again by the next ddm::run()
+			 * @note call this function when the DThreads are not executed, i.e. before or after ddm::run()
+			 */
+			inline void rearm() {
+				m_tsu->rearmDThread(m_tid);
+			}
+
+			/**
+			 * Set the Scheduling Policy of the DThread, i.e. the method that is used by the TSU to map the ready instances to the Kernels
+			 * @param method the Scheduling Method (DYNAMIC, PRODUCER_AFFINE, STATIC or BLOCK)
+			 * @param value the Scheduling Value. For PRODUCER_AFFINE it is the queue depth of the producer Kernel above which the
+			 * instances are scheduled dynamically and for BLOCK it is the number of consecutive instances that run on the same Kernel.
+			 * If it is zero a default value is used.
+			 */
+			inline void setSchedulingPolicy(SchedulingMethod method, UInt value = 0) {
+				m_tsu->setSchedulingPolicy(m_tid, method, value);
+			}
+
+			/**
+			 * Set the CUSTOM Scheduling Policy of the DThread
+			 * @param function maps the context of a ready instance to the Kernel that will execute it
+			 */
+			inline void setSchedulingPolicy(SchedulingFunction function) {
+				m_tsu->setSchedulingPolicy(m_tid, function);
+			}
+
+			/**
+			 * Set the Priority of the DThread. The ready instances with higher priority are executed first (e.g. the DThreads of the critical path).
+			 * @param priority the priority, from DEFAULT_PRIORITY (the lowest) up to PRIORITY_LEVELS - 1
+			 */
+			inline void setPriority(UInt priority) {
+				m_tsu->setPriority(m_tid, priority);
+			}
+
+			/**
+			 * Set the Priority of the DThread that is computed per context
+			 * @param function returns the priority of a ready instance based on its context
+			 */
+			inline void setPriority(PriorityFunction function) {
+				m_tsu->setPriority(m_tid, function);
+			}
+
 			/**
 			 * Prints the Consumers of the DThread
 			 */
@@ -186,11 +229,12 @@ namespace ddm {
 			 * @param[in] mDFunction the pointer of the DThread's function
 			 * @param[in] readyCount the Dthread's Ready Count, i.e. the number of its producer-threads
 			 * @param[in] numOfInstances the number of instances of the DThread
-			 * @note A static SM will be used
+			 * @param[in] smType the storage of the DThread's SM
+			 * @note A static SM will be used, unless smType selects a dynamic storage (HASH_SM, BTREE_SM or SPARSE_SM)
 			 */
-			MultipleDThread(MultipleDFunction mDFunction, ReadyCount readyCount, UInt numOfInstances) {
+			MultipleDThread(MultipleDFunction mDFunction, ReadyCount readyCount, UInt numOfInstances, SMType smType = SMType::AUTO_SM) {
 				m_ifp.multipleDFunction = mDFunction;
-				m_tid = m_tsu->addDThread(&m_ifp, Nesting::ONE, readyCount, numOfInstances, 1, 1);  // Store the Thread Template in the TSU
+				m_tid = m_tsu->addDThread(&m_ifp, Nesting::ONE, readyCount, numOfInstances, 1, 1, smType);  // Store the Thread Template in the TSU
 				m_isFastExecute = (readyCount == 1);
 			}
 
@@ -198,11 +242,13 @@ namespace ddm {
 			 * Inserts a MultipleDThread in the TSU
 			 * @param[in] mDFunction the pointer of the DThread's function
 			 * @param[in] readyCount the Dthread's Ready Count, i.e. the number of its producer-threads
+			 * @param[in] smType the storage of the DThread's Dynamic SM (HASH_SM, BTREE_SM, SPARSE_SM or AUTO_SM)
+			 * @param[in] initialCapacity the initial number of slots of the HASH_SM storage, e.g. the expected number of pending instances
 			 * @note A dynamic SM will be used
 			 */
-			MultipleDThread(MultipleDFunction mDFunction, ReadyCount readyCount) {
+			MultipleDThread(MultipleDFunction mDFunction, ReadyCount readyCount, SMType smType = SMType::AUTO_SM, size_t initialCapacity = DYNAMIC_SM_INITIAL_CAPACITY) {
 				m_ifp.multipleDFunction = mDFunction;
-				m_tid = m_tsu->addDThread(&m_ifp, Nesting::ONE, readyCount);  // Store the Thread Template in the TSU
+				m_tid = m_tsu->addDThread(&m_ifp, Nesting::ONE, readyCount, smType, initialCapacity);  // Store the Thread Template in the TSU
 				m_isFastExecute = (readyCount == 1);
 			}
 
@@ -272,11 +318,27 @@ namespace ddm {
 			 * @param[in] readyCount the Dthread's Ready Count, i.e. the number of its producer-threads
 			 * @param[in] innerRange the range of the inner Context
 			 * @param[in] outerRange the range of the outer Context
-			 * @note A static SM will be used
+			 * @param[in] smType the storage of the DThread's SM
+			 * @note A static SM will be used, unless smType selects a dynamic storage (HASH_SM, BTREE_SM or SPARSE_SM)
 			 */
-			MultipleDThread2D(MultipleDFunction2D mDFunction2D, ReadyCount readyCount, UInt innerRange, UInt outerRange) {
+			MultipleDThread2D(MultipleDFunction2D mDFunction2D, ReadyCount readyCount, UInt innerRange, UInt outerRange, SMType smType = SMType::AUTO_SM) {
 				m_ifp.multipleDFunction2D = mDFunction2D;
-				m_tid = m_tsu->addDThread(&m_ifp, Nesting::TWO, readyCount, innerRange, 1, outerRange);  // Store the Thread Template in the TSU
+				m_tid = m_tsu->addDThread(&m_ifp, Nesting::TWO, readyCount, innerRange, 1, outerRange, smType);  // Store the Thread Template in the TSU
+				m_isFastExecute = (readyCount == 1);
+			}
+
+			/**
+			 * Inserts a MultipleDThread2D in the TSU whose Contexts are restricted to a domain, e.g. Inner > Outer
+			 * @param[in] mDFunction2D the pointer of the DThread's function
+			 * @param[in] readyCount the Dthread's Ready Count, i.e. the number of its producer-threads
+			 * @param[in] innerRange the range of the inner Context
+			 * @param[in] outerRange the range of the outer Context
+			 * @param[in] domain the domain of the Contexts (see ContextDomain.h)
+			 * @note A static SM will be used that holds only the Ready Counts of the domain
+			 */
+			MultipleDThread2D(MultipleDFunction2D mDFunction2D, ReadyCount readyCount, UInt innerRange, UInt outerRange, const ContextDomain& domain) {
+				m_ifp.multipleDFunction2D = mDFunction2D;
+				m_tid = m_tsu->addDThread(&m_ifp, Nesting::TWO, readyCount, innerRange, 1, outerRange, SMType::DENSE_SM, &domain);  // Store the Thread Template in the TSU
 				m_isFastExecute = (readyCount == 1);
 			}
 
@@ -284,11 +346,13 @@ namespace ddm {
 			 * Inserts a MultipleDThread2D in the TSU
 			 * @param[in] mDFunction2D the pointer of the DThread's function
 			 * @param[in] readyCount the Dthread's Ready Count, i.e. the number of its producer-threads
+			 * @param[in] smType the storage of the DThread's Dynamic SM (HASH_SM, BTREE_SM, SPARSE_SM or AUTO_SM)
+			 * @param[in] initialCapacity the initial number of slots of the HASH_SM storage, e.g. the expected number of pending instances
 			 * @note A dynamic SM will be used
 			 */
-			MultipleDThread2D(MultipleDFunction2D mDFunction2D, ReadyCount readyCount) {
+			MultipleDThread2D(MultipleDFunction2D mDFunction2D, ReadyCount readyCount, SMType smType = SMType::AUTO_SM, size_t initialCapacity = DYNAMIC_SM_INITIAL_CAPACITY) {
 				m_ifp.multipleDFunction2D = mDFunction2D;
-				m_tid = m_tsu->addDThread(&m_ifp, Nesting::TWO, readyCount);  // Store the Thread Template in the TSU
+				m_tid = m_tsu->addDThread(&m_ifp, Nesting::TWO, readyCount, smType, initialCapacity);  // Store the Thread Template in the TSU
 				m_isFastExecute = (readyCount == 1);
 			}
 
@@ -382,11 +446,30 @@ namespace ddm {
 			 * @param[in] innerRange the range of the inner Context
 			 * @param[in] middleRange the range of the middle Context
 			 * @param[in] outerRange the range of the outer Context
-			 * @note A static SM will be used
+			 * @param[in] smType the storage of the DThread's SM
+			 * @note A static SM will be used, unless smType selects a dynamic storage (HASH_SM, BTREE_SM or SPARSE_SM)
+			 */
+			MultipleDThread3D(MultipleDFunction3D mDFunction3D, ReadyCount readyCount, UInt innerRange, UInt middleRange, UInt outerRange,
+			    SMType smType = SMType::AUTO_SM) {
+				m_ifp.multipleDFunction3D = mDFunction3D;
+				m_tid = m_tsu->addDThread(&m_ifp, Nesting::THREE, readyCount, innerRange, middleRange, outerRange, smType);  // Store the Thread Template in the TSU
+				m_isFastExecute = (readyCount == 1);
+			}
+
+			/**
+			 * Inserts a MultipleDThread3D in the TSU whose Contexts are restricted to a domain, e.g. Middle > Outer and Inner > Outer
+			 * @param[in] mDFunction3D the pointer of the DThread's function
+			 * @param[in] readyCount the Dthread's Ready Count, i.e. the number of its producer-threads
+			 * @param[in] innerRange the range of the inner Context
+			 * @param[in] middleRange the range of the middle Context
+			 * @param[in] outerRange the range of the outer Context
+			 * @param[in] domain the domain of the Contexts (see ContextDomain.h)
+			 * @note A static SM will be used that holds only the Ready Counts of the domain
 			 */
-			MultipleDThread3D(MultipleDFunction3D mDFunction3D, ReadyCount readyCount, UInt innerRange, UInt middleRange, UInt outerRange) {
+			MultipleDThread3D(MultipleDFunction3D mDFunction3D, ReadyCount readyCount, UInt innerRange, UInt middleRange, UInt outerRange,
+			    const ContextDomain& domain) {
 				m_ifp.multipleDFunction3D = mDFunction3D;
-				m_tid = m_tsu->addDThread(&m_ifp, Nesting::THREE, readyCount, innerRange, middleRange, outerRange);  // Store the Thread Template in the TSU
+				m_tid = m_tsu->addDThread(&m_ifp, Nesting::THREE, readyCount, innerRange, middleRange, outerRange, SMType::DENSE_SM, &domain);  // Store the Thread Template in the TSU
 				m_isFastExecute = (readyCount == 1);
 			}
 
@@ -394,11 +477,13 @@ namespace ddm {
 			 * Inserts a MultipleDThread3D in the TSU
 			 * @param[in] mDFunction3D the pointer of the DThread's function
 			 * @param[in] readyCount the Dthread's Ready Count, i.e. the number of its producer-threads
+			 * @param[in] smType the storage of the DThread's Dynamic SM (HASH_SM, BTREE_SM, SPARSE_SM or AUTO_SM)
+			 * @param[in] initialCapacity the initial number of slots of the HASH_SM storage, e.g. the expected number of pending instances
 			 * @note A dynamic SM will be used
 			 */
-			MultipleDThread3D(MultipleDFunction3D mDFunction3D, ReadyCount readyCount) {
+			MultipleDThread3D(MultipleDFunction3D mDFunction3D, ReadyCount readyCount, SMType smType = SMType::AUTO_SM, size_t initialCapacity = DYNAMIC_SM_INITIAL_CAPACITY) {
 				m_ifp.multipleDFunction3D = mDFunction3D;
-				m_tid = m_tsu->addDThread(&m_ifp, Nesting::THREE, readyCount);  // Store the Thread Template in the TSU
+				m_tid = m_tsu->addDThread(&m_ifp, Nesting::THREE, readyCount, smType, initialCapacity);  // Store the Thread Template in the TSU
 				m_isFastExecute = (readyCount == 1);
 			}
 
@@ -49,7 +49,6 @@ namespace ddm {
 
 	// Global Variables
 	static TSU* m_tsu;
-	static SimpleHashTable<pthread_t, KernelID>* m_pidTokidMap;  // A hash-map that holds the PThread IDs - KernelIDs pairs
 
 	// For Distributed execution
 	static NetworkManager* m_network;  // The network manager
@@ -61,6 +60,7 @@ namespace ddm {
 	static UInt m_numOfPeers = 0;  // The number of peers of the distributed system
 	static freddo_config* freddoConfig;  // Configuration object. Will be created in the init functions or will be retrieved by the programmer through its programs.
 	static bool confRuntimeCreated = false;  // Indicates if the runtime creates the config file
+	static bool m_isDistExecuted = false;  // Indicates if the distributed execution is finished. It can not be repeated.
 
 
 	/**
@@ -140,22 +140,24 @@ namespace ddm {
 
 		// Create the TSU object
 		m_tsu = new TSU(m_localNumOfKernels, conf->getTsuPinningCore(), numOfPeers, conf->isTsuPinningEnable());
+		m_tsu->setWorkStealing(conf->isWorkStealingEnabled());
+		m_tsu->setInputQueueBurst(conf->getInputQueueBurst());
+		m_tsu->setIdlePolicy(conf->getIdleSpinIterations(), conf->getIdleYieldIterations(), conf->isIdleParkingEnabled(), conf->getIdleParkTimeout());
+		m_tsu->setDecentralizedUpdates(conf->isDecentralizedUpdatesEnabled());
+		m_tsu->setDirectExecution(conf->isDirectExecutionEnabled());
+		m_tsu->setInlineExecutionDepth(conf->getInlineExecutionDepth());
+		m_tsu->setSpillMemorySoftLimit(conf->getSpillMemorySoftLimit());
+		m_tsu->setSchedulerThreads(conf->getSchedulerThreads());
 
 		// Start the Kernels
 		m_tsu->startKernels(conf->getFirstKernelPinningCore(), conf->isKernelsPinningEnable());
 
-		// Allocated the m_pidTokidMap
-		m_pidTokidMap = new SimpleHashTable<pthread_t, KernelID>(Auxiliary::pow2roundup(m_localNumOfKernels * 3));
-
 		/*
-		 *  For each Kernel create an association between its PThread ID and its Kernel ID.
+		 *  Each Kernel stores its KernelID in a thread-local variable when it starts.
 		 *  This is used in order to avoid putting the KernelIDs as DFunctions' arguments.
+		 *  The main thread gets the MAIN_THREAD_KERNEL_ID, i.e. the initial updates will be sent to the Input Queue of Kernel-0.
 		 */
-		for (UInt i = 0; i < m_localNumOfKernels; ++i)
-			m_pidTokidMap->add(m_tsu->getKernelPThreadID(i), m_tsu->getKernelID(i));
-
-		// Add the PThreadID of main in the m_pidTokidMap hash-map. This is used for the initial updates.
-		m_pidTokidMap->add(pthread_self(), 0);  // This means that the initial updates will be sent to the Input Queue of Kernel-0
+		Kernel::threadKernelID() = MAIN_THREAD_KERNEL_ID;
 	}
 
 	/**
@@ -177,6 +179,14 @@ namespace ddm {
 
 		// Create the TSU object
 		m_tsu = new TSU(kernels, conf->getTsuPinningCore(), 1, conf->isTsuPinningEnable());
+		m_tsu->setWorkStealing(conf->isWorkStealingEnabled());
+		m_tsu->setInputQueueBurst(conf->getInputQueueBurst());
+		m_tsu->setIdlePolicy(conf->getIdleSpinIterations(), conf->getIdleYieldIterations(), conf->isIdleParkingEnabled(), conf->getIdleParkTimeout());
+		m_tsu->setDecentralizedUpdates(conf->isDecentralizedUpdatesEnabled());
+		m_tsu->setDirectExecution(conf->isDirectExecutionEnabled());
+		m_tsu->setInlineExecutionDepth(conf->getInlineExecutionDepth());
+		m_tsu->setSpillMemorySoftLimit(conf->getSpillMemorySoftLimit());
+		m_tsu->setSchedulerThreads(conf->getSchedulerThreads());
 
 		if (conf->getKernelsFirstCorePlace() == PINNING_PLACE::ON_NET_MANAGER || conf->getKernelsFirstCorePlace() == PINNING_PLACE::NEXT_NET_MANAGER) {
 			//printf("Warning: the KernelsFirstCorePlace cannot be ON_NET_MANAGER or NEXT_NET_MANAGER because single-node mode is used. KernelsFirstCorePlace set to NEXT_TSU.\n");
@@ -186,32 +196,26 @@ namespace ddm {
 		// Start the Kernels
 		m_tsu->startKernels(conf->getFirstKernelPinningCore(), conf->isKernelsPinningEnable());
 
-		// Allocated the m_pidTokidMap
-		m_pidTokidMap = new SimpleHashTable<pthread_t, KernelID>(Auxiliary::pow2roundup(kernels * 3));
-
 		/*
-		 *  For each Kernel create an association between its PThread ID and its Kernel ID.
+		 *  Each Kernel stores its KernelID in a thread-local variable when it starts.
 		 *  This is used in order to avoid putting the KernelIDs as DFunctions' arguments.
+		 *  The main thread gets the MAIN_THREAD_KERNEL_ID, i.e. the initial updates will be sent to the Input Queue of Kernel-0.
 		 */
-		for (UInt i = 0; i < kernels; ++i)
-			m_pidTokidMap->add(m_tsu->getKernelPThreadID(i), m_tsu->getKernelID(i));
-
-		// Add the PThreadID of main in the m_pidTokidMap hash-map. This is used for the initial updates.
-		m_pidTokidMap->add(pthread_self(), 0);
+		Kernel::threadKernelID() = MAIN_THREAD_KERNEL_ID;
 	}
 
 	/**
 	 * @return the KernelID of the currently executed Kernel
 	 */
 	static inline KernelID getKernelIDofKernel() {
-		KernelID* temp = m_pidTokidMap->getValue(pthread_self());
+		KernelID kernelID = Kernel::threadKernelID();
 
-		if (!temp) {
-			printf("Error in getKernelIDofKernel => The PThread ID does not exists.\n");
+		if (kernelID == EXTERNAL_THREAD_ID) {
+			printf("Error in getKernelIDofKernel => The calling thread is neither a Kernel nor the main thread.\n");
 			exit(ERROR);
 		}
 
-		return *temp;
+		return kernelID;
 	}
 
 	/**
@@ -226,14 +230,34 @@ namespace ddm {
 	 *	@note the scheduling will finish if the TSU has no updates to execute (the Input Queues are empty)
 	 *	and no pending ready DThreads (the Output Queues are empty). As such, you should add the DThreads you
 	 *	need and send the initial updates before you call this function.
+	 *	In single-node mode the function can be called repeatedly, i.e. the Kernels are kept alive between the executions.
+	 *	Call resetGraph() (or rearm() for specific DThreads) before sending the initial updates of the next execution.
 	 */
 	inline void run(void) {
 		finalizeDependencyGraph();  // Find the RC values of the Pending Thread Templates
 
-		if (m_isSingleNode)
+		if (m_isSingleNode) {
 			m_tsu->runSingleNode();  // Run the TSU in single peer mode
-		else
-			m_tsu->runDist(m_network);  // Run the TSU in distributed mode
+			return;
+		}
+
+		// The Network Manager stops when the distributed termination is detected
+		if (m_isDistExecuted) {
+			printf("Error in run => The distributed execution can not be repeated.\n");
+			exit(ERROR);
+		}
+
+		m_tsu->runDist(m_network);  // Run the TSU in distributed mode
+		m_isDistExecuted = true;
+	}
+
+	/**
+	 * Restores the initial Ready Counts of all the DThreads, such as, the DDM Dependency Graph can be executed again by
+	 * calling run(). The DThreads and the memory of their SMs are reused.
+	 * @note call this function after run() and before sending the initial updates of the next execution
+	 */
+	inline void resetGraph() {
+		m_tsu->resetGraph();
 	}
 
 	/**
@@ -246,7 +270,6 @@ namespace ddm {
 		if (!m_isSingleNode)
 			m_network->stop();
 
-		delete m_pidTokidMap;
 		delete m_tsu;
 
 		// In distributed mode destroy the Distributed Scheduler and the Network Unit
@@ -305,6 +328,14 @@ namespace ddm {
 		printf("================================================\n");
 	}
 
+	/**
+	 * @return the counters of the backpressure that is applied to the Kernels when the spill memory budget is exhausted
+	 * @note call this function after the run() function
+	 */
+	inline SpillStatistics getSpillStatistics() {
+		return m_tsu->getSpillStatistics();
+	}
+
 /////////////////////// Special Functions for the Distributed Version ///////////////////////
 
 	/**
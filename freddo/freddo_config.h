@@ -30,6 +30,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include "ddm_defs.h"
 
 typedef enum {
 	ON_TSU, NEXT_TSU, ON_NET_MANAGER, NEXT_NET_MANAGER
@@ -47,6 +49,17 @@ class freddo_config {
 			m_net_manager_pin_place = PINNING_PLACE::NEXT_TSU;
 			m_kernelsPinningEnabled = true;
 			m_kernels_starting_core_pin_place = PINNING_PLACE::NEXT_NET_MANAGER;
+			m_workStealingEnabled = false;
+			m_inputQueueBurst = DEFAULT_IQ_BURST;
+			m_schedulerThreads = DEFAULT_SCHEDULER_THREADS;
+			m_idleSpinIterations = UINT_MAX;
+			m_idleYieldIterations = 0;
+			m_idleParkingEnabled = false;
+			m_idleParkTimeout = DEFAULT_PARK_TIMEOUT;
+			m_decentralizedUpdatesEnabled = false;
+			m_directExecutionEnabled = false;
+			m_inlineExecutionDepth = DEFAULT_INLINE_DEPTH;
+			m_spillMemorySoftLimit = DEFAULT_SPILL_MEMORY_SOFT_LIMIT;
 		}
 
 		// Default destructor
@@ -177,6 +190,146 @@ class freddo_config {
 			return m_kernelsPinningEnabled;
 		}
 
+		/* ********************* Scheduling ********************* */
+		/**
+		 * Set the maximum number of updates that the TSU processes from an Input Queue before moving to the next one
+		 */
+		inline void setInputQueueBurst(unsigned int burstSize) {
+			m_inputQueueBurst = burstSize;
+		}
+
+		inline unsigned int getInputQueueBurst() {
+			return m_inputQueueBurst;
+		}
+
+		/**
+		 * Set the number of the TSU threads. Each thread applies the updates of the DThreads with tid % threads == its ID.
+		 * The number is limited to the number of the Kernels and it is always 1 in distributed mode.
+		 */
+		inline void setSchedulerThreads(unsigned int threads) {
+			m_schedulerThreads = threads;
+		}
+
+		inline unsigned int getSchedulerThreads() {
+			return m_schedulerThreads;
+		}
+
+		/**
+		 * Enable the work-stealing, i.e. the idle Kernels steal ready DThreads from the other Kernels
+		 */
+		inline void enableWorkStealing() {
+			m_workStealingEnabled = true;
+		}
+
+		/**
+		 * Disable the work-stealing, i.e. the TSU assigns each ready DThread to the Kernel with the least amount of work (default)
+		 */
+		inline void disableWorkStealing() {
+			m_workStealingEnabled = false;
+		}
+
+		inline bool isWorkStealingEnabled() {
+			return m_workStealingEnabled;
+		}
+
+		/**
+		 * Enable the decentralized updates, i.e. the Kernels decrement the Ready Counts of their updates
+		 * and execute the instances that become ready without the intervention of the TSU
+		 */
+		inline void enableDecentralizedUpdates() {
+			m_decentralizedUpdatesEnabled = true;
+		}
+
+		/**
+		 * Disable the decentralized updates, i.e. all updates are applied by the TSU
+		 */
+		inline void disableDecentralizedUpdates() {
+			m_decentralizedUpdatesEnabled = false;
+		}
+
+		inline bool isDecentralizedUpdatesEnabled() {
+			return m_decentralizedUpdatesEnabled;
+		}
+
+		/**
+		 * Enable the direct execution, i.e. the Kernels schedule the instances of the DThreads with Ready Count 1 in their own
+		 * Work-Stealing Deques, without the intervention of the TSU
+		 */
+		inline void enableDirectExecution() {
+			m_directExecutionEnabled = true;
+		}
+
+		/**
+		 * Disable the direct execution, i.e. the updates of the DThreads with Ready Count 1 are sent to the TSU
+		 */
+		inline void disableDirectExecution() {
+			m_directExecutionEnabled = false;
+		}
+
+		inline bool isDirectExecutionEnabled() {
+			return m_directExecutionEnabled;
+		}
+
+		/**
+		 * Set the maximum number of nested DThreads that a Kernel executes inside the DThread that made them ready, when they are
+		 * scheduled by the Kernel itself (direct execution or decentralized updates). Zero disables the inline execution (default).
+		 */
+		inline void setInlineExecutionDepth(unsigned int depth) {
+			m_inlineExecutionDepth = depth;
+		}
+
+		inline unsigned int getInlineExecutionDepth() {
+			return m_inlineExecutionDepth;
+		}
+
+		/**
+		 * Set the soft limit (in bytes) of the memory of the updates that are spilled when the Input Queues are full. When the limit is
+		 * reached, a Kernel executes ready DThreads or waits instead of allocating more memory. If waiting makes no progress the limit
+		 * is exceeded, in order to avoid deadlocks (see the forcedSpills and the peakAllocatedBytes of ddm::getSpillStatistics).
+		 * Zero means unlimited (default).
+		 */
+		inline void setSpillMemorySoftLimit(size_t bytes) {
+			m_spillMemorySoftLimit = bytes;
+		}
+
+		inline size_t getSpillMemorySoftLimit() {
+			return m_spillMemorySoftLimit;
+		}
+
+		/* ********************* Idle Policy ********************* */
+		/**
+		 * Set the idle policy of the Kernels, the TSU and the Network Manager. An idle thread spins for spinIterations,
+		 * then it yields its core for yieldIterations and finally, if parking is enabled, it sleeps until new work arrives.
+		 * By default the idle threads spin forever.
+		 * @param spinIterations the number of idle iterations in which a thread busy-waits
+		 * @param yieldIterations the number of idle iterations in which a thread yields its core
+		 * @param enableParking if true, a thread parks after the spinning and the yielding
+		 * @param parkTimeout the maximum time (in microseconds) that a thread stays parked
+		 */
+		inline void setIdlePolicy(unsigned int spinIterations, unsigned int yieldIterations, bool enableParking,
+		    unsigned int parkTimeout = DEFAULT_PARK_TIMEOUT) {
+			m_idleSpinIterations = spinIterations;
+			m_idleYieldIterations = yieldIterations;
+			m_idleParkingEnabled = enableParking;
+			m_idleParkTimeout = parkTimeout;
+		}
+
+		inline unsigned int getIdleSpinIterations() {
+			return m_idleSpinIterations;
+		}
+
+		inline unsigned int getIdleYieldIterations() {
+			return m_idleYieldIterations;
+		}
+
+		inline bool isIdleParkingEnabled() {
+			return m_idleParkingEnabled;
+		}
+
+		inline unsigned int getIdleParkTimeout() {
+			return m_idleParkTimeout;
+		}
+
 		/**
 		 * Print the map of the pinning
 		 */
@@ -196,6 +349,18 @@ class freddo_config {
 
 		bool m_kernelsPinningEnabled = true;  // Enable the pinning of the Kernels to the cores
 		PINNING_PLACE m_kernels_starting_core_pin_place;  // The place of the core of the first Kernel
+
+		unsigned int m_inputQueueBurst;  // The maximum number of updates that the TSU processes from an Input Queue at once
+		unsigned int m_schedulerThreads;  // The number of the TSU threads that apply the updates
+		bool m_workStealingEnabled = false;  // Indicates if the idle Kernels steal ready DThreads from the other Kernels
+		bool m_decentralizedUpdatesEnabled = false;  // Indicates if the Kernels apply their updates by themselves
+		bool m_directExecutionEnabled = false;  // Indicates if the Kernels schedule the DThreads with Ready Count 1 by themselves
+		unsigned int m_inlineExecutionDepth;  // The maximum number of nested DThreads that a Kernel executes inline
+		size_t m_spillMemorySoftLimit;  // The soft limit (in bytes) of the memory of the spilled updates. Zero means unlimited.
+		unsigned int m_idleSpinIterations;  // The number of idle iterations in which a runtime thread busy-waits
+		unsigned int m_idleYieldIterations;  // The number of idle iterations in which a runtime thread yields its core
+		bool m_idleParkingEnabled;  // Indicates if the idle runtime threads park
+		unsigned int m_idleParkTimeout;  // The maximum time (in microseconds) that an idle runtime thread stays parked
 };
 
 #endif /* FREDDO_CONFIG_H_ */
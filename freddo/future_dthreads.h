@@ -65,22 +65,24 @@ namespace ddm {
          * After that the FutureMultipleDThread will be converted to MultipleDThread and it will be stored in TSU.
          * @param[in] mDFunction the pointer of the DThread's function
          * @param[in] numOfInstances the number of instances of the DThread
-         * @note A static SM will be used
+         * @param[in] smType the storage of the DThread's SM
+         * @note A static SM will be used, unless smType selects a dynamic storage (HASH_SM, BTREE_SM or SPARSE_SM)
          */
-        FutureMultipleDThread(MultipleDFunction mDFunction, UInt numOfInstances) {
+        FutureMultipleDThread(MultipleDFunction mDFunction, UInt numOfInstances, SMType smType = SMType::AUTO_SM) {
             m_ifp.multipleDFunction = mDFunction;
-            m_tid = m_tsu->addDThread(&m_ifp, Nesting::ONE, numOfInstances, 1, 1);  // Inserts a Pending DThread
+            m_tid = m_tsu->addDThread(&m_ifp, Nesting::ONE, numOfInstances, 1, 1, smType);  // Inserts a Pending DThread
         }
 
         /**
          * Creates a FutureMultipleDThread object. The RC of the DThread will be evaluated at runtime.
          * After that the FutureMultipleDThread will be converted to MultipleDThread and it will be stored in TSU.
          * @param[in] mDFunction the pointer of the DThread's function
+         * @param[in] smType the storage of the DThread's Dynamic SM (HASH_SM, BTREE_SM, SPARSE_SM or AUTO_SM)
          * @note A dynamic SM will be used
          */
-        FutureMultipleDThread(MultipleDFunction mDFunction) {
+        FutureMultipleDThread(MultipleDFunction mDFunction, SMType smType = SMType::AUTO_SM) {
             m_ifp.multipleDFunction = mDFunction;
-            m_tid = m_tsu->addDThread(&m_ifp, Nesting::ONE);  // Inserts a Pending DThread
+            m_tid = m_tsu->addDThread(&m_ifp, Nesting::ONE, smType);  // Inserts a Pending DThread
         }
     };
 
@@ -95,22 +97,24 @@ namespace ddm {
          * @param[in] mDFunction2D the pointer of the DThread's function
          * @param[in] innerRange the range of the inner Context
          * @param[in] outerRange the range of the outer Context
-         * @note A static SM will be used
+         * @param[in] smType the storage of the DThread's SM
+         * @note A static SM will be used, unless smType selects a dynamic storage (HASH_SM, BTREE_SM or SPARSE_SM)
          */
-        FutureMultipleDThread2D(MultipleDFunction2D mDFunction2D, UInt innerRange, UInt outerRange) {
+        FutureMultipleDThread2D(MultipleDFunction2D mDFunction2D, UInt innerRange, UInt outerRange, SMType smType = SMType::AUTO_SM) {
             m_ifp.multipleDFunction2D = mDFunction2D;
-            m_tid = m_tsu->addDThread(&m_ifp, Nesting::TWO, innerRange, 1, outerRange);  // Inserts a Pending DThread
+            m_tid = m_tsu->addDThread(&m_ifp, Nesting::TWO, innerRange, 1, outerRange, smType);  // Inserts a Pending DThread
         }
 
         /**
          * Creates a FutureMultipleDThread2D object. The RC of the DThread will be evaluated at runtime.
          * After that the FutureMultipleDThread2D will be converted to MultipleDThread2D and it will be stored in TSU.
          * @param[in] mDFunction2D the pointer of the DThread's function
+         * @param[in] smType the storage of the DThread's Dynamic SM (HASH_SM, BTREE_SM, SPARSE_SM or AUTO_SM)
          * @note A dynamic SM will be used
          */
-        FutureMultipleDThread2D(MultipleDFunction2D mDFunction2D) {
+        FutureMultipleDThread2D(MultipleDFunction2D mDFunction2D, SMType smType = SMType::AUTO_SM) {
             m_ifp.multipleDFunction2D = mDFunction2D;
-            m_tid = m_tsu->addDThread(&m_ifp, Nesting::TWO);  // Inserts a Pending DThread
+            m_tid = m_tsu->addDThread(&m_ifp, Nesting::TWO, smType);  // Inserts a Pending DThread
         }
     };
 
@@ -126,22 +130,25 @@ namespace ddm {
          * @param[in] innerRange the range of the inner Context
          * @param[in] middleRange the range of the middle Context
          * @param[in] outerRange the range of the outer Context
-         * @note A static SM will be used
+         * @param[in] smType the storage of the DThread's SM
+         * @note A static SM will be used, unless smType selects a dynamic storage (HASH_SM, BTREE_SM or SPARSE_SM)
          */
-        FutureMultipleDThread3D(MultipleDFunction3D mDFunction3D, UInt innerRange, UInt middleRange, UInt outerRange) {
+        FutureMultipleDThread3D(MultipleDFunction3D mDFunction3D, UInt innerRange, UInt middleRange, UInt outerRange,
+            SMType smType = SMType::AUTO_SM) {
             m_ifp.multipleDFunction3D = mDFunction3D;
-            m_tid = m_tsu->addDThread(&m_ifp, Nesting::THREE, innerRange, middleRange, outerRange);  // Inserts a Pending DThread
+            m_tid = m_tsu->addDThread(&m_ifp, Nesting::THREE, innerRange, middleRange, outerRange, smType);  // Inserts a Pending DThread
         }
 
         /**
          * Creates a FutureMultipleDThread3D object. The RC of the DThread will be evaluated at runtime.
          * After that the FutureMultipleDThread3D will be converted to MultipleDThread3D and it will be stored in TSU.
          * @param[in] mDFunction3D the pointer of the DThread's function
+         * @param[in] smType the storage of the DThread's Dynamic SM (HASH_SM, BTREE_SM, SPARSE_SM or AUTO_SM)
          * @note A dynamic SM will be used
          */
-        FutureMultipleDThread3D(MultipleDFunction3D mDFunction3D) {
+        FutureMultipleDThread3D(MultipleDFunction3D mDFunction3D, SMType smType = SMType::AUTO_SM) {
             m_ifp.multipleDFunction3D = mDFunction3D;
-            m_tid = m_tsu->addDThread(&m_ifp, Nesting::THREE);  // Inserts a Pending DThread
+            m_tid = m_tsu->addDThread(&m_ifp, Nesting::THREE, smType);  // Inserts a Pending DThread
         }
     };
 }